@@ -1,4 +1,5 @@
 #include "schedule_filter.h"
+#include "ScheduleSet.h"
 
 ScheduleFilter::ScheduleFilter(QObject *parent) : QObject(parent) {
 }
@@ -10,40 +11,50 @@ std::vector<InformativeSchedule> ScheduleFilter::filterSchedules(const std::vect
 
     std::vector<InformativeSchedule> filtered;
 
+    const bool anyEnabled = criteria.daysToStudyEnabled || criteria.totalGapsEnabled || criteria.maxGapsTimeEnabled ||
+                            criteria.avgDayStartEnabled || criteria.avgDayEndEnabled;
+
     for (const auto& schedule : schedules) {
         bool passesAllFilters = true;
 
+        // Compact schedules are expanded once here and the week is shared by all criteria
+        std::vector<ScheduleDay> expandedWeek;
+        if (anyEnabled && schedule.week.empty() && schedule.source) {
+            expandedWeek = ScheduleSet::weekOf(schedule);
+        }
+        const std::vector<ScheduleDay>& week = schedule.week.empty() ? expandedWeek : schedule.week;
+
         // Check Days to Study Filter (Active Days)
         if (criteria.daysToStudyEnabled) {
-            if (!meetsDaysToStudyCriteria(schedule, criteria)) {
+            if (!meetsDaysToStudyCriteria(week, criteria)) {
                 passesAllFilters = false;
             }
         }
 
         // Check Total Gaps Filter
         if (criteria.totalGapsEnabled && passesAllFilters) {
-            if (!meetsTotalGapsCriteria(schedule, criteria)) {
+            if (!meetsTotalGapsCriteria(week, criteria)) {
                 passesAllFilters = false;
             }
         }
 
         // Check Max Gaps Time Filter
         if (criteria.maxGapsTimeEnabled && passesAllFilters) {
-            if (!meetsMaxGapsTimeCriteria(schedule, criteria)) {
+            if (!meetsMaxGapsTimeCriteria(week, criteria)) {
                 passesAllFilters = false;
             }
         }
 
         // Check Average Day Start Filter
         if (criteria.avgDayStartEnabled && passesAllFilters) {
-            if (!meetsAvgDayStartCriteria(schedule, criteria)) {
+            if (!meetsAvgDayStartCriteria(week, criteria)) {
                 passesAllFilters = false;
             }
         }
 
         // Check Average Day End Filter
         if (criteria.avgDayEndEnabled && passesAllFilters) {
-            if (!meetsAvgDayEndCriteria(schedule, criteria)) {
+            if (!meetsAvgDayEndCriteria(week, criteria)) {
                 passesAllFilters = false;
             }
         }
@@ -58,10 +69,10 @@ std::vector<InformativeSchedule> ScheduleFilter::filterSchedules(const std::vect
     return filtered;
 }
 
-int ScheduleFilter::countActiveDays(const InformativeSchedule& schedule) {
+int ScheduleFilter::countActiveDays(const std::vector<ScheduleDay>& week) {
     int activeDays = 0;
 
-    for (const auto& day : schedule.week) {
+    for (const auto& day : week) {
         if (!day.day_items.empty()) {
             activeDays++;
         }
@@ -70,24 +81,24 @@ int ScheduleFilter::countActiveDays(const InformativeSchedule& schedule) {
     return activeDays;
 }
 
-bool ScheduleFilter::meetsDaysToStudyCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria) {
+bool ScheduleFilter::meetsDaysToStudyCriteria(const std::vector<ScheduleDay>& week, const FilterCriteria& criteria) {
     if (!criteria.daysToStudyEnabled) {
         return true;
     }
 
     // Count active days (days with courses) and check if it's <= max allowed
-    int activeDays = countActiveDays(schedule);
+    int activeDays = countActiveDays(week);
     return activeDays <= criteria.daysToStudyValue;
 }
 
-bool ScheduleFilter::meetsTotalGapsCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria) {
+bool ScheduleFilter::meetsTotalGapsCriteria(const std::vector<ScheduleDay>& week, const FilterCriteria& criteria) {
     if (!criteria.totalGapsEnabled) {
         return true;
     }
 
     int totalGaps = 0;
 
-    for (const auto& day : schedule.week) {
+    for (const auto& day : week) {
         if (day.day_items.size() <= 1) {
             continue; // No gaps possible with 0 or 1 items
         }
@@ -115,14 +126,14 @@ bool ScheduleFilter::meetsTotalGapsCriteria(const InformativeSchedule& schedule,
     return totalGaps <= criteria.totalGapsValue;
 }
 
-bool ScheduleFilter::meetsMaxGapsTimeCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria) {
+bool ScheduleFilter::meetsMaxGapsTimeCriteria(const std::vector<ScheduleDay>& week, const FilterCriteria& criteria) {
     if (!criteria.maxGapsTimeEnabled) {
         return true;
     }
 
     int maxGapTime = 0;
 
-    for (const auto& day : schedule.week) {
+    for (const auto& day : week) {
         if (day.day_items.size() <= 1) {
             continue;
         }
@@ -151,7 +162,7 @@ bool ScheduleFilter::meetsMaxGapsTimeCriteria(const InformativeSchedule& schedul
     return maxGapTime <= criteria.maxGapsTimeValue;
 }
 
-bool ScheduleFilter::meetsAvgDayStartCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria) {
+bool ScheduleFilter::meetsAvgDayStartCriteria(const std::vector<ScheduleDay>& week, const FilterCriteria& criteria) {
     if (!criteria.avgDayStartEnabled) {
         return true;
     }
@@ -159,7 +170,7 @@ bool ScheduleFilter::meetsAvgDayStartCriteria(const InformativeSchedule& schedul
     int totalStartTime = 0;
     int activeDays = 0;
 
-    for (const auto& day : schedule.week) {
+    for (const auto& day : week) {
         if (day.day_items.empty()) {
             continue;
         }
@@ -187,7 +198,7 @@ bool ScheduleFilter::meetsAvgDayStartCriteria(const InformativeSchedule& schedul
     return avgStartTime >= criteriaStartTime;
 }
 
-bool ScheduleFilter::meetsAvgDayEndCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria) {
+bool ScheduleFilter::meetsAvgDayEndCriteria(const std::vector<ScheduleDay>& week, const FilterCriteria& criteria) {
     if (!criteria.avgDayEndEnabled) {
         return true;
     }
@@ -195,7 +206,7 @@ bool ScheduleFilter::meetsAvgDayEndCriteria(const InformativeSchedule& schedule,
     int totalEndTime = 0;
     int activeDays = 0;
 
-    for (const auto& day : schedule.week) {
+    for (const auto& day : week) {
         if (day.day_items.empty()) {
             continue;
         }
@@ -43,12 +43,13 @@ public:
     vector<InformativeSchedule> filterSchedules(const vector<InformativeSchedule>& schedules,
                                                 const FilterCriteria& criteria);
 
-    static int countActiveDays(const InformativeSchedule& schedule);
-    static bool meetsDaysToStudyCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria);
-    static bool meetsTotalGapsCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria);
-    static bool meetsMaxGapsTimeCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria);
-    static bool meetsAvgDayStartCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria);
-    static bool meetsAvgDayEndCriteria(const InformativeSchedule& schedule, const FilterCriteria& criteria);
+    // Criteria checks on the week layout of one schedule
+    static int countActiveDays(const vector<ScheduleDay>& week);
+    static bool meetsDaysToStudyCriteria(const vector<ScheduleDay>& week, const FilterCriteria& criteria);
+    static bool meetsTotalGapsCriteria(const vector<ScheduleDay>& week, const FilterCriteria& criteria);
+    static bool meetsMaxGapsTimeCriteria(const vector<ScheduleDay>& week, const FilterCriteria& criteria);
+    static bool meetsAvgDayStartCriteria(const vector<ScheduleDay>& week, const FilterCriteria& criteria);
+    static bool meetsAvgDayEndCriteria(const vector<ScheduleDay>& week, const FilterCriteria& criteria);
 
 signals:
     void filteringStarted();
@@ -1,8 +1,9 @@
 #include "ScheduleGenerator.h"
 
-ScheduleGenerator::ScheduleGenerator(IModel* modelConn, const std::vector<Course>& courses, QString semester)
+ScheduleGenerator::ScheduleGenerator(IModel* modelConn, const std::vector<Course>& courses, QString semester,
+                                     const ScheduleConstraints& constraints)
         : modelConnection(modelConn),
-          coursesToProcess(courses),
+          request(courses, constraints),
           semesterName(std::move(semester)) {}
 
 void ScheduleGenerator::generateSchedules() {
@@ -16,7 +17,7 @@ void ScheduleGenerator::generateSchedules() {
             return;
         }
 
-        if (coursesToProcess.empty()) {
+        if (request.courses.empty()) {
             qDebug() << "ScheduleGenerator: ERROR - No courses to process";
             emit schedulesGenerated(nullptr);
             return;
@@ -26,7 +27,7 @@ void ScheduleGenerator::generateSchedules() {
         schedulePtr = static_cast<std::vector<InformativeSchedule>*>(
                 modelConnection->executeOperation(
                         ModelOperation::GENERATE_SCHEDULES,
-                        &coursesToProcess,
+                        &request,
                         semesterName.toStdString()
                 )
         );
@@ -11,7 +11,8 @@ class ScheduleGenerator : public QObject {
 Q_OBJECT
 
 public:
-    ScheduleGenerator(IModel* model, const vector<Course>& courses, QString  semester);
+    ScheduleGenerator(IModel* model, const vector<Course>& courses, QString  semester,
+                      const ScheduleConstraints& constraints = {});
 
 public slots:
     void generateSchedules();
@@ -21,6 +22,6 @@ signals:
 
 private:
     IModel* modelConnection;
-    vector<Course> coursesToProcess;
+    ScheduleGenerationRequest request;
     QString semesterName;
 };
\ No newline at end of file
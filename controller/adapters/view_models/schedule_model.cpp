@@ -1,4 +1,5 @@
 #include "schedule_model.h"
+#include "ScheduleSet.h"
 #include <set>
 
 ScheduleModel::ScheduleModel(QObject *parent)
@@ -49,11 +50,12 @@ QVariantList ScheduleModel::getDayItems(int scheduleIndex, int dayIndex) const {
     if (scheduleIndex < 0 || scheduleIndex >= static_cast<int>(activeSchedules.size()))
         return {};
 
-    if (dayIndex < 0 || dayIndex >= static_cast<int>(activeSchedules[scheduleIndex].week.size()))
+    const vector<ScheduleDay>& week = weekFor(activeSchedules[scheduleIndex]);
+    if (dayIndex < 0 || dayIndex >= static_cast<int>(week.size()))
         return {};
 
     QVariantList items;
-    for (const auto &item : activeSchedules[scheduleIndex].week[dayIndex].day_items) {
+    for (const auto &item : week[dayIndex].day_items) {
         QVariantMap itemMap;
         itemMap["courseName"] = QString::fromStdString(item.courseName);
         itemMap["raw_id"] = QString::fromStdString(item.raw_id);
@@ -67,6 +69,22 @@ QVariantList ScheduleModel::getDayItems(int scheduleIndex, int dayIndex) const {
     return items;
 }
 
+const vector<ScheduleDay>& ScheduleModel::weekFor(const InformativeSchedule& schedule) const {
+    if (!schedule.week.empty()) {
+        return schedule.week;
+    }
+
+    // Compact schedules are expanded once and reused for the per-day queries of the view
+    if (!m_cachedWeekValid || m_cachedWeekSource != schedule.source ||
+        m_cachedWeekPosition != schedule.source_position) {
+        m_cachedWeek = ScheduleSet::weekOf(schedule);
+        m_cachedWeekSource = schedule.source;
+        m_cachedWeekPosition = schedule.source_position;
+        m_cachedWeekValid = true;
+    }
+    return m_cachedWeek;
+}
+
 QVariantList ScheduleModel::getCurrentDayItems(int dayIndex) const {
     return getDayItems(m_currentScheduleIndex, dayIndex);
 }
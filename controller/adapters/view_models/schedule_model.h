@@ -83,6 +83,12 @@ private:
     int m_currentScheduleIndex;
     bool m_isFiltered;
 
+    // Last expanded week of a compact schedule
+    mutable vector<ScheduleDay> m_cachedWeek;
+    mutable shared_ptr<const ScheduleSet> m_cachedWeekSource;
+    mutable size_t m_cachedWeekPosition = 0;
+    mutable bool m_cachedWeekValid = false;
+
     // Unique ID mappings
     QStringList m_allUniqueIds;                       // All schedule unique IDs
     QStringList m_filteredUniqueIds;                  // Currently filtered unique IDs
@@ -93,6 +99,7 @@ private:
     void updateFilteredSchedules();
     void resetCurrentIndex();
     const vector<InformativeSchedule>& getActiveSchedules() const;
+    const vector<ScheduleDay>& weekFor(const InformativeSchedule& schedule) const;
 
     // Unique ID helper methods
     void updateUniqueIdMappings();
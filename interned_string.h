@@ -0,0 +1,70 @@
+#ifndef INTERNED_STRING_H
+#define INTERNED_STRING_H
+
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+using namespace std;
+
+// Handle to a string stored once in a process-wide pool. Schedule items repeat the same few
+// hundred course names, types, times and rooms across every schedule, so they hold handles
+// instead of copies. Interning takes a lock; reading, copying and comparing handles do not.
+// Pooled strings live until the process exits.
+class InternedString {
+public:
+    InternedString() : value(emptyValue()) {}
+    explicit InternedString(const string& text) : value(intern(text)) {}
+    explicit InternedString(const char* text) : value(intern(text)) {}
+
+    InternedString& operator=(const string& text) { value = intern(text); return *this; }
+    InternedString& operator=(const char* text) { value = intern(text); return *this; }
+
+    const string& str() const { return *value; }
+    operator const string&() const { return *value; }
+
+    const char* c_str() const { return value->c_str(); }
+    size_t size() const { return value->size(); }
+    bool empty() const { return value->empty(); }
+    string substr(size_t pos = 0, size_t count = string::npos) const { return value->substr(pos, count); }
+    size_t find(const char* text, size_t pos = 0) const { return value->find(text, pos); }
+    size_t find(char c, size_t pos = 0) const { return value->find(c, pos); }
+
+    // Equal strings share one pooled value, so handles compare by address
+    bool operator==(const InternedString& other) const { return value == other.value; }
+    bool operator!=(const InternedString& other) const { return value != other.value; }
+    bool operator<(const InternedString& other) const { return *value < *other.value; }
+
+    friend bool operator==(const InternedString& a, const string& b) { return *a.value == b; }
+    friend bool operator==(const string& a, const InternedString& b) { return a == *b.value; }
+    friend bool operator==(const InternedString& a, const char* b) { return *a.value == b; }
+    friend bool operator!=(const InternedString& a, const string& b) { return *a.value != b; }
+    friend bool operator!=(const InternedString& a, const char* b) { return *a.value != b; }
+
+    friend string operator+(const string& a, const InternedString& b) { return a + *b.value; }
+    friend string operator+(const InternedString& a, const string& b) { return *a.value + b; }
+    friend string operator+(const char* a, const InternedString& b) { return a + *b.value; }
+    friend string operator+(const InternedString& a, const char* b) { return *a.value + b; }
+
+    friend ostream& operator<<(ostream& out, const InternedString& text) { return out << *text.value; }
+
+private:
+    const string* value;
+
+    static const string* intern(const string& text) {
+        static mutex poolMutex;
+        static unordered_set<string> pool;
+
+        lock_guard<mutex> lock(poolMutex);
+        return &*pool.insert(text).first;
+    }
+
+    static const string* emptyValue() {
+        static const string* const empty = intern(string());
+        return empty;
+    }
+};
+
+#endif //INTERNED_STRING_H
@@ -4,10 +4,16 @@
 #include "model_interfaces.h"
 #include "model_db_integration.h"
 #include "logger.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
 #include <memory>
 
+// Persists generated schedules in the background. Batches go through a bounded queue to a writer
+// thread with its own SQLite connection, so callers only wait when the queue is full.
 class ScheduleDatabaseWriter {
 public:
     static ScheduleDatabaseWriter& getInstance();
@@ -19,37 +25,67 @@ public:
     bool initializeSession();
 
     bool writeSchedule(const InformativeSchedule& schedule);
+    bool writeSchedules(const vector<InformativeSchedule>& schedules);
+
+    // Queues the remaining schedules; they are written in the background
     bool finalizeSession();
 
+    // Blocks until the session is finalized and every queued schedule is written; false if any write
+    // failed since the session began
+    bool waitUntilIdle();
+
+    // Writes what is queued and stops the writer thread. The owner calls this (or cancel) before
+    // exit; the destructor runs too late for Qt and SQL work and does not stop the thread.
+    void shutdown();
+
+    // Drops what is queued and stops the writer thread once the batch being written is done
+    void cancel();
+
     // Get statistics about the current session
     struct SessionStats {
         int totalSchedulesWritten = 0;
         int successfulWrites = 0;
         int failedWrites = 0;
+        int queuedSchedules = 0;
         bool sessionActive = false;
     };
 
-    SessionStats getSessionStats() const { return sessionStats; }
+    SessionStats getSessionStats() const;
 
     // Batch writing for better performance
-    void setBatchSize(int size) { batchSize = size; }
-    bool flushBatch(); // Manually flush current batch
+    void setBatchSize(int size);
+    void setMaxQueuedSchedules(int size);
+    bool flushBatch(); // Manually queue current batch
 
 private:
     ScheduleDatabaseWriter() = default;
     ~ScheduleDatabaseWriter();
 
+    mutable mutex stateMutex;
+    condition_variable queueChanged;
+
     // Internal state
     bool sessionActive = false;
     SessionStats sessionStats;
 
     // Batch writing
-    int batchSize = 100;
+    int batchSize = 1000;
+    int maxQueuedSchedules = 50000;
     std::vector<InformativeSchedule> currentBatch;
 
+    // Batches waiting for the writer thread, and whether it is writing one
+    deque<vector<InformativeSchedule>> pendingBatches;
+    bool writing = false;
+    bool stopping = false;
+    thread writerThread;
+    QString databasePath;
+
     // Internal methods
-    bool writeBatchToDatabase();
+    bool queueBatchLocked(unique_lock<mutex>& lock);
+    void stopWriter(bool discardQueued);
+    void run();
+    bool writeBatchToDatabase(DatabaseScheduleManager& schedules, const vector<InformativeSchedule>& batch);
     void resetSession();
 };
 
-#endif // SCHEDULE_DATABASE_WRITER_H
\ No newline at end of file
+#endif // SCHEDULE_DATABASE_WRITER_H
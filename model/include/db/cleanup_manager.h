@@ -3,6 +3,7 @@
 
 #include "db_manager.h"
 #include "model_db_integration.h"
+#include "ScheduleDatabaseWriter.h"
 #include "logger.h"
 
 class CleanupManager {
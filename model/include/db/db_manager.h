@@ -15,12 +15,16 @@
 #include <QSqlDriver>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QThread>
 #include <QDateTime>
 #include <QVariant>
 #include <QString>
 #include <vector>
 #include <string>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <QDir>
 
 using namespace std;
@@ -36,10 +40,20 @@ public:
     bool isConnected() const;
     void closeDatabase();
 
-    DatabaseFileManager* files() { return fileManager.get(); }
-    DatabaseCourseManager* courses() { return courseManager.get(); }
+    // File of the open database, for components that open their own connection to it
+    QString databasePath() const { return db.databaseName(); }
+
+    // Managers bound to the calling thread's connection. The thread that opened the database uses the
+    // main connection; other threads get their own connection to the same file on first use, so they
+    // read in parallel with each other and with the background writer. After the database is closed,
+    // a thread's next call replaces its connection, so earlier managers of that thread are invalid.
+    DatabaseFileManager* files();
+    DatabaseCourseManager* courses();
     DatabaseSchema* schema() { return schemaManager.get(); }
 
+    // Closes the calling thread's own connection; done automatically when the thread exits
+    void releaseThreadConnection();
+
     bool insertMetadata(const string& key, const string& value, const string& description = "");
     bool updateMetadata(const string& key, const string& value);
     string getMetadata(const string& key, const string& defaultValue = "");
@@ -53,7 +67,7 @@ public:
 
     static int getCurrentSchemaVersion() { return CURRENT_SCHEMA_VERSION; }
 
-    DatabaseScheduleManager* schedules() { return scheduleManager.get(); }
+    DatabaseScheduleManager* schedules();
 
 private:
     DatabaseManager() = default;
@@ -69,16 +83,45 @@ private:
 
     bool executeQuery(const QString& query, const QVariantList& params = QVariantList());
 
+    // Connection of one thread other than the opening one, with the managers bound to it. Only that
+    // thread closes it: closing the database marks it retired, and the thread replaces or releases
+    // it on its next use or when it exits.
+    struct ThreadConnection {
+        QString name;
+        QSqlDatabase db;
+        QThread* thread = nullptr;  // thread ids are reused, so the entry is checked against this too
+        bool retired = false;
+        std::unique_ptr<DatabaseFileManager> fileManager;
+        std::unique_ptr<DatabaseCourseManager> courseManager;
+        std::unique_ptr<DatabaseScheduleManager> scheduleManager;
+    };
+
+    // nullptr on the opening thread, or when no connection could be opened (the main one is used then)
+    ThreadConnection* threadConnection();
+    ThreadConnection* openThreadConnection();
+    QSqlDatabase& connection();
+    void retireThreadConnections();
+    static void closeThreadConnection(std::unique_ptr<ThreadConnection> threadConnection);
+
     static bool isQtApplicationReady();
 
     QSqlDatabase db;
     bool isInitialized = false;
 
+    // Read by worker threads, so kept apart from db and set under connectionsMutex by the opening thread
+    void setConnected(bool open);
+    bool connected = false;
+    std::thread::id ownerThread;
+
+    mutable std::mutex connectionsMutex;
+    std::map<std::thread::id, std::unique_ptr<ThreadConnection>> threadConnections;
+    int nextConnectionId = 0;
+
     std::unique_ptr<DatabaseSchema> schemaManager;
     std::unique_ptr<DatabaseFileManager> fileManager;
     std::unique_ptr<DatabaseCourseManager> courseManager;
 
-    static const int CURRENT_SCHEMA_VERSION = 1;
+    static const int CURRENT_SCHEMA_VERSION = 4;
 
     friend class DatabaseRepair;
     std::unique_ptr<DatabaseScheduleManager> scheduleManager;
@@ -0,0 +1,42 @@
+#ifndef DB_SCHEDULE_BLOB_H
+#define DB_SCHEDULE_BLOB_H
+
+#include "model_interfaces.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Compact binary form of a schedule's week, stored in schedule.schedule_data instead of JSON text.
+//
+// Layout (all integers are unsigned LEB128 varints):
+//   version byte
+//   string table: count, then per string its length and bytes
+//   days: count, then per day its name (string id) and item count
+//   item columns, each holding one value per item in day order:
+//     courseName, raw_id, type, building, room (string ids), start, end (time codes)
+//
+// A time code is (minutes << 2) | form: form 0 is "HH:MM", form 1 is "H:MM", and form 2 stores a
+// string id in place of the minutes for times in any other format.
+class DatabaseScheduleBlob {
+public:
+    static const uint8_t VERSION = 1;
+
+    static string encode(const InformativeSchedule& schedule);
+    static string encodeWeek(const vector<ScheduleDay>& week);
+
+    // Replaces the week with the decoded days; false (and an empty week) on malformed blobs
+    static bool decode(const string& blob, InformativeSchedule& schedule);
+    static bool decodeWeek(const string& blob, vector<ScheduleDay>& week);
+
+    // Option tuple of a normalized schedule row: one varint option index per course
+    static string encodeTuple(const vector<uint32_t>& tuple);
+    static bool decodeTuple(const string& blob, vector<uint32_t>& tuple);
+
+private:
+    DatabaseScheduleBlob() = default; // Static class, no instantiation
+};
+
+#endif // DB_SCHEDULE_BLOB_H
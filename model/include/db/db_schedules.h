@@ -4,6 +4,8 @@
 #include "db_entities.h"
 #include "model_interfaces.h"
 #include "db_json_helpers.h"
+#include "db_schedule_blob.h"
+#include "ScheduleSet.h"
 #include "db_utils.h"
 #include "logger.h"
 
@@ -11,9 +13,12 @@
 #include <QSqlError>
 #include <QVariant>
 #include <QSqlDatabase>
+#include <QStringList>
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <memory>
 
 using namespace std;
 
@@ -43,16 +48,45 @@ public:
     // Utility operations
     int getScheduleCount();
 
+    // Highest generation session (unique_key >> 32) of the stored schedules, 0 when there is none
+    qint64 getHighestSession();
+
     // Performance operations for bulk inserts
     bool insertSchedulesBulk(const vector<InformativeSchedule>& schedules);
 
+    // Multi-row statements are the default; off inserts one row per statement through
+    // DatabaseUtils::executeBatch, which the insert benchmark compares against
+    void setMultiRowInserts(bool enabled) { multiRowInserts = enabled; }
+
 private:
+    // Connection of the thread this manager belongs to (see DatabaseManager::schedules)
     QSqlDatabase& db;
 
-    mutable mutex dbMutex;
+    // Prepared INSERT statements, keyed by table and rows per statement
+    map<QString, QSqlQuery> statements;
+    bool multiRowInserts = true;
+
+    // Generation row created by this manager, with the options already stored. Chunks of one
+    // generation arrive in separate insert calls, so the rows are kept by session key.
+    struct StoredGeneration {
+        qint64 id = -1;
+        set<uint64_t> storedOptions;  // course position << 32 | option index
+    };
+    map<qint64, StoredGeneration> generations;
+
+    // Generations met while loading, by generation id; loaded schedules point into them and
+    // join their week from the stored option weeks on demand
+    using StoredSets = map<qint64, shared_ptr<ScheduleSet>>;
 
     // Helper methods
-    static InformativeSchedule createScheduleFromQuery(QSqlQuery& query);
+    QSqlQuery* cachedStatement(const QString& insert, const QString& rowValues, int rows);
+    // Runs in the caller's transaction
+    bool insertRows(const QString& insert, const QString& rowValues, const vector<QVariantList>& rows);
+    bool storeGeneration(const InformativeSchedule& schedule, vector<QVariantList>& optionData,
+                         const StoredGeneration*& generation);
+    void forgetUncommittedGenerations(const set<qint64>& knownGenerations);
+    const shared_ptr<ScheduleSet>& loadGeneration(qint64 generationId, StoredSets& storedSets);
+    InformativeSchedule createScheduleFromQuery(QSqlQuery& query, StoredSets& storedSets);
     static bool isValidScheduleQuery(const string& sqlQuery);
     vector<string> getWhitelistedTables();
     static vector<string> getWhitelistedColumns();
@@ -7,6 +7,8 @@
 #include <QString>
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QStringList>
+#include <vector>
 
 class DatabaseSchema {
 public:
@@ -24,13 +26,14 @@ public:
 
 private:
     QSqlDatabase& db;
-    static const int CURRENT_SCHEMA_VERSION = 1;
+    static const int CURRENT_SCHEMA_VERSION = 4;
 
     // Individual table creation methods
     bool createMetadataTable();
     bool createFileTable();
     bool createCourseTable();
     bool createScheduleTable();
+    bool createScheduleGenerationTables();
 
     // Index creation methods
     bool createFileIndexes();
@@ -8,6 +8,7 @@
 #include <vector>
 #include <string>
 #include <functional>
+#include <mutex>
 
 class DatabaseUtils {
 public:
@@ -16,9 +17,9 @@ public:
     static bool optimizeForBulkInserts(QSqlDatabase& db);
     static bool restoreNormalSettings(QSqlDatabase& db);
 
-    // Batch operation helpers
+    // Batch operation helpers; with ownTransaction false the rows join the caller's transaction
     static bool executeBatch(QSqlDatabase& db, const QString& query,
-                             const std::vector<QVariantList>& batchData);
+                             const std::vector<QVariantList>& batchData, bool ownTransaction = true);
 
     // Database maintenance
     static bool vacuum(QSqlDatabase& db);
@@ -56,12 +57,13 @@ public:
         std::string lastError;
     };
 
-    static PerformanceStats& getStats();
+    static PerformanceStats getStats();  // snapshot, since queries are recorded concurrently
     static void resetStats();
     static void logPerformanceReport();
 
 private:
     static PerformanceStats performanceStats;
+    static std::mutex statsMutex; // Queries are recorded from every thread's connection
     static void recordQuery(bool success, double timeMs, const std::string& error = "");
 };
 
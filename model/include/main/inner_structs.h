@@ -2,25 +2,97 @@
 #define INNER_STRUCTS_H
 
 #include "model_interfaces.h"
+#include "WeekMask.h"
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+// Day and start/end minutes of one selected session
+struct SessionTime {
+    int day;
+    int start;
+    int end;
+};
+
+// Index of each group type in CourseSelection::groups
+enum GroupSlot : size_t {
+    BLOCK_SLOT, LECTURE_SLOT, TUTORIAL_SLOT, LAB_SLOT, DEPARTMENTAL_SLOT, REINFORCEMENT_SLOT,
+    GUIDANCE_SLOT, COLLOQUIUM_SLOT, REGISTRATION_SLOT, THESIS_SLOT, PROJECT_SLOT, GROUP_SLOT_COUNT
+};
 
 struct CourseSelection {
-    int courseId;
-    const Group* lectureGroup;
-    const Group* tutorialGroup;       // nullptr if none
-    const Group* labGroup;            // nullptr if none
-    const Group* blockGroup;          // nullptr if none
-    const Group* departmentalGroup;   // nullptr if none
-    const Group* reinforcementGroup;  // nullptr if none
-    const Group* guidanceGroup;       // nullptr if none
-    const Group* colloquiumGroup;     // nullptr if none
-    const Group* registrationGroup;   // nullptr if none
-    const Group* thesisGroup;         // nullptr if none
-    const Group* projectGroup;        // nullptr if none
+    int courseId = 0;
+    array<const Group*, GROUP_SLOT_COUNT> groups{}; // chosen group of each type, nullptr if none
+    WeekMask occupancy;                             // union of all selected groups' sessions
+    vector<SessionTime> sessionTimes;               // every selected session with valid times, in GROUP_TYPE_SLOTS order
+
+    const Group* blockGroup() const { return groups[BLOCK_SLOT]; }
+    const Group* lectureGroup() const { return groups[LECTURE_SLOT]; }
+    const Group* tutorialGroup() const { return groups[TUTORIAL_SLOT]; }
+    const Group* labGroup() const { return groups[LAB_SLOT]; }
+    const Group* departmentalGroup() const { return groups[DEPARTMENTAL_SLOT]; }
+    const Group* reinforcementGroup() const { return groups[REINFORCEMENT_SLOT]; }
+    const Group* guidanceGroup() const { return groups[GUIDANCE_SLOT]; }
+    const Group* colloquiumGroup() const { return groups[COLLOQUIUM_SLOT]; }
+    const Group* registrationGroup() const { return groups[REGISTRATION_SLOT]; }
+    const Group* thesisGroup() const { return groups[THESIS_SLOT]; }
+    const Group* projectGroup() const { return groups[PROJECT_SLOT]; }
 };
 
+// Where the groups of one session type live in a Course, which CourseSelection slot receives
+// the chosen group and how its sessions are labeled in a schedule
+struct GroupTypeSlot {
+    SessionType type;
+    vector<Group> Course::* groups;
+    GroupSlot slot;
+    const char* label;
+};
+
+// Group types in the order they are combined (blocks first, then lectures, tutorials and labs)
+inline constexpr array<GroupTypeSlot, GROUP_SLOT_COUNT> GROUP_TYPE_SLOTS = {{
+        {SessionType::BLOCK, &Course::blocks, BLOCK_SLOT, "Block"},
+        {SessionType::LECTURE, &Course::Lectures, LECTURE_SLOT, "Lecture"},
+        {SessionType::TUTORIAL, &Course::Tirgulim, TUTORIAL_SLOT, "Tutorial"},
+        {SessionType::LAB, &Course::labs, LAB_SLOT, "Lab"},
+        {SessionType::DEPARTMENTAL_SESSION, &Course::DepartmentalSessions, DEPARTMENTAL_SLOT, "Departmental"},
+        {SessionType::REINFORCEMENT, &Course::Reinforcements, REINFORCEMENT_SLOT, "Reinforcement"},
+        {SessionType::GUIDANCE, &Course::Guidance, GUIDANCE_SLOT, "Guidance"},
+        {SessionType::OPTIONAL_COLLOQUIUM, &Course::OptionalColloquium, COLLOQUIUM_SLOT, "Colloquium"},
+        {SessionType::REGISTRATION, &Course::Registration, REGISTRATION_SLOT, "Registration"},
+        {SessionType::THESIS, &Course::Thesis, THESIS_SLOT, "Thesis"},
+        {SessionType::PROJECT, &Course::Project, PROJECT_SLOT, "Project"}
+}};
+
+// Pooled strings of one session, shared by every schedule item it produces
+struct SessionStrings {
+    InternedString start;
+    InternedString end;
+    InternedString building;
+    InternedString room;
+};
+
+// Strings of a course interned once per build, so laying out a schedule copies no text
 struct CourseInfo {
-    string raw_id;
-    string name;
+    InternedString raw_id;
+    InternedString name;
+    unordered_map<const Session*, SessionStrings> sessions;
+
+    CourseInfo() = default;
+    CourseInfo(const string& rawId, const string& courseName) : raw_id(rawId), name(courseName) {}
+
+    // Interns the id, name and the strings of every session of the course
+    explicit CourseInfo(const Course& course) : CourseInfo(course.raw_id, course.name) {
+        for (const auto& slot : GROUP_TYPE_SLOTS) {
+            for (const auto& group : course.*slot.groups) {
+                for (const auto& session : group.sessions) {
+                    sessions[&session] = {InternedString(session.start_time), InternedString(session.end_time),
+                                          InternedString(session.building_number),
+                                          InternedString(session.room_number)};
+                }
+            }
+        }
+    }
 };
 
 #endif //INNER_STRUCTS_H
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "claude_api_integration.h"
 #include "schedule_filter_service.h"
 #include "cleanup_manager.h"
+#include "ScheduleDatabaseWriter.h"
 
 #include <algorithm>
 #include <cctype>
@@ -56,8 +57,9 @@ private:
     static vector<string> validateCourses(const vector<Course>& courses);
 
     // Schedule generator
-    static vector<InformativeSchedule> generateSchedules(const vector<Course>& userInput, const string& semester);
-    static bool saveSchedulesToDB(const vector<InformativeSchedule>& schedules, const string& semester);
+    static vector<InformativeSchedule> generateSchedules(const vector<Course>& userInput, const string& semester,
+                                                         const ScheduleConstraints& constraints = {});
+    static uint64_t countSchedules(const vector<Course>& userInput);
 
     // Schedule export
     static void saveSchedule(const InformativeSchedule& infoSchedule, const string& path);
@@ -79,6 +81,11 @@ private:
     static vector<Course> lastGeneratedCourses;
     static vector<InformativeSchedule> lastGeneratedSchedules;
     static map<string, vector<InformativeSchedule>> semesterSchedules;
+
+    // Set of the last generation per semester, reused when the next one only adds a course or
+    // block times
+    static mutex scheduleSetsMutex;
+    static map<string, shared_ptr<const ScheduleSet>> lastScheduleSets;
 };
 
 inline IModel* getModel() {
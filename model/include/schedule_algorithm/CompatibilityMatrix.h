@@ -0,0 +1,62 @@
+#ifndef COMPATIBILITY_MATRIX_H
+#define COMPATIBILITY_MATRIX_H
+
+#include "model_interfaces.h"
+#include "inner_structs.h"
+#include "getSession.h"
+#include "TimeUtils.h"
+#include "WeekMask.h"
+
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// Dynamic bitset over the options (CourseSelections) of a single course
+using OptionBitset = vector<uint64_t>;
+
+// Pairwise compatibility between the option sets of all courses in a build: for every ordered pair
+// of courses (i, j) and every option a of course i, a bitset of the options of j that do not
+// conflict with a. Computed once per build so the backtracker only ANDs bitsets.
+class CompatibilityMatrix {
+public:
+    void build(const vector<vector<CourseSelection>>& allOptions);
+
+    // Options of course j that are compatible with option a of course i (i != j)
+    const uint64_t* compatible(size_t i, size_t a, size_t j) const {
+        return &cells[pairOffsets[i * courseCount + j] + a * wordCounts[j]];
+    }
+
+    size_t wordCount(size_t course) const { return wordCounts[course]; }
+
+    // Bitset with one bit set for every option of the course
+    OptionBitset allOptionsOf(size_t course) const;
+
+    // Checks if there is a time conflict between two CourseSelections
+    static bool hasConflict(const CourseSelection& a, const CourseSelection& b);
+
+    static size_t countOptions(const OptionBitset& bits);
+
+    static int lowestBit(uint64_t word) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+
+private:
+    size_t courseCount = 0;
+    vector<size_t> optionCounts;
+    vector<size_t> wordCounts;
+    vector<size_t> pairOffsets;
+    vector<uint64_t> cells;
+};
+
+#endif // COMPATIBILITY_MATRIX_H
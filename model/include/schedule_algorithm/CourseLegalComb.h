@@ -5,6 +5,7 @@
 #include "inner_structs.h"
 #include "Logger.h"
 #include "TimeUtils.h"
+#include "WeekMask.h"
 #include <vector>
 #include <string>
 
@@ -19,21 +20,25 @@ private:
     // Helper method to check if two groups have any conflicting sessions
     bool hasGroupConflict(const Group* group1, const Group* group2);
 
-    // Recursive helper method to generate all combinations
+    // Recursive helper method to generate all combinations; occupied is the union of the groups
+    // chosen so far and groupMasks holds the occupancy of every group of the available types
     void generateCombinationsRecursive(
-            const vector<pair<string, vector<const Group*>>>& availableGroupTypes,
+            const Course& course,
+            const vector<const GroupTypeSlot*>& availableGroupTypes,
+            const vector<vector<WeekMask>>& groupMasks,
             int currentTypeIndex,
             vector<const Group*>& currentCombination,
-            vector<CourseSelection>& combinations,
-            int courseId);
+            const WeekMask& occupied,
+            vector<CourseSelection>& combinations);
 
-    // Helper method to check if any groups in the combination have conflicts
-    bool hasAnyCombinationConflict(const vector<const Group*>& groups);
+    // Helper method to check if a group conflicts with any group already chosen
+    bool hasConflictWithChosen(const Group* group, const WeekMask& mask,
+                               const vector<const Group*>& chosen, const WeekMask& occupied);
 
     // Helper method to create CourseSelection from the selected groups
     CourseSelection createCourseSelection(
             const vector<const Group*>& selectedGroups,
-            const vector<pair<string, vector<const Group*>>>& availableGroupTypes,
+            const vector<const GroupTypeSlot*>& availableGroupTypes,
             int courseId);
 };
-#endif // COURSE_LEGAL_COMB_H
\ No newline at end of file
+#endif // COURSE_LEGAL_COMB_H
@@ -0,0 +1,120 @@
+#ifndef METRICS_ACCUMULATOR_H
+#define METRICS_ACCUMULATOR_H
+
+#pragma once
+
+#include "inner_structs.h"
+
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Sessions of a (partial) schedule kept sorted per day in fixed-size arrays, plus the per-day and
+// total class time. Options are pushed and popped in stack order along a search path, so a leaf
+// only has to derive the gap metrics and partial schedules can be bounded early.
+class MetricsAccumulator {
+public:
+    static constexpr int MAX_DAY_SESSIONS = 64;
+
+    // Adds the sessions of an option (days outside 1-7 are ignored)
+    void push(const CourseSelection& option) {
+        marks.emplace_back(undoLog.size(), skipped);
+
+        for (const SessionTime& time : option.sessionTimes) {
+            if (time.day < 1 || time.day > 7) continue;
+
+            int& count = counts[time.day];
+            if (count == MAX_DAY_SESSIONS) {
+                skipped++;
+                continue;
+            }
+
+            // Insert after equal intervals so the order does not depend on the push order
+            auto& daySessions = sessions[time.day];
+            pair<int, int> interval(time.start, time.end);
+            int position = count;
+            while (position > 0 && interval < daySessions[position - 1]) {
+                daySessions[position] = daySessions[position - 1];
+                position--;
+            }
+            daySessions[position] = interval;
+
+            if (count++ == 0) usedDays++;
+            dayClassTimes[time.day] += time.end - time.start;
+            totalClassTime += time.end - time.start;
+            undoLog.emplace_back(static_cast<uint8_t>(time.day), static_cast<uint8_t>(position));
+        }
+    }
+
+    // Removes the sessions of the last pushed option
+    void pop() {
+        if (marks.empty()) return;
+
+        size_t mark = marks.back().first;
+        skipped = marks.back().second;
+        marks.pop_back();
+
+        while (undoLog.size() > mark) {
+            int day = undoLog.back().first;
+            int position = undoLog.back().second;
+            undoLog.pop_back();
+
+            auto& daySessions = sessions[day];
+            int duration = daySessions[position].second - daySessions[position].first;
+            dayClassTimes[day] -= duration;
+            totalClassTime -= duration;
+            for (int i = position; i + 1 < counts[day]; i++) {
+                daySessions[i] = daySessions[i + 1];
+            }
+            if (--counts[day] == 0) usedDays--;
+        }
+    }
+
+    int count(int day) const { return counts[day]; }
+    const pair<int, int>& session(int day, int i) const { return sessions[day][i]; }
+
+    // Start of the first and end of the last session of a day, for days that have sessions
+    int dayStart(int day) const { return sessions[day][0].first; }
+    int dayEnd(int day) const { return sessions[day][counts[day] - 1].second; }
+    int dayClassTime(int day) const { return dayClassTimes[day]; }
+
+    int daysUsed() const { return usedDays; }
+    int classTime() const { return totalClassTime; }
+
+    // INT_MAX / 0 while the schedule is empty
+    int earliestStart() const {
+        int earliest = INT_MAX;
+        for (int day = 1; day <= 7; day++) {
+            if (counts[day] > 0) earliest = min(earliest, dayStart(day));
+        }
+        return earliest;
+    }
+
+    int latestEnd() const {
+        int latest = 0;
+        for (int day = 1; day <= 7; day++) {
+            if (counts[day] > 0) latest = max(latest, dayEnd(day));
+        }
+        return latest;
+    }
+
+    // True while a day of the pushed options holds more than MAX_DAY_SESSIONS sessions; the extra
+    // ones are left out, so the per-day values are incomplete
+    bool overflowed() const { return skipped > 0; }
+
+private:
+    array<array<pair<int, int>, MAX_DAY_SESSIONS>, 8> sessions{};
+    array<int, 8> counts{};
+    array<int, 8> dayClassTimes{};
+    int usedDays = 0;
+    int totalClassTime = 0;
+    int skipped = 0;
+
+    // (day, position) of every inserted session, and the log size and skipped count at each push
+    vector<pair<uint8_t, uint8_t>> undoLog;
+    vector<pair<size_t, int>> marks;
+};
+
+#endif //METRICS_ACCUMULATOR_H
@@ -6,54 +6,341 @@
 #include "inner_structs.h"
 #include "getSession.h"
 #include "TimeUtils.h"
+#include "WeekMask.h"
+#include "MetricsAccumulator.h"
+#include "ScheduleId.h"
+#include "WorkStealingPool.h"
+#include "CompatibilityMatrix.h"
+#include "ScheduleSet.h"
+#include "ScheduleObjective.h"
 #include "logger.h"
 #include "ScheduleDatabaseWriter.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <algorithm>
+#include <array>
 #include <vector>
-#include <random>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <queue>
 #include <map>
+#include <memory>
+#include <limits>
 
 class ScheduleBuilder {
 public:
+    // Receives the next chunk of schedules in generation order, with index and unique_id already
+    // assigned. The chunk may be moved from. Returning false stops the generation.
+    using ScheduleChunkCallback = function<bool(vector<InformativeSchedule>& chunk)>;
+
     // Public method to build all possible valid schedules from a list of courses
     vector<InformativeSchedule> build(const vector<Course>& courses, const string& semester);
 
+    // Streams the schedules to onChunk in chunks of chunkSize (the last one may be smaller), so only
+    // a few chunks per worker are held in memory at a time. Returns the number of schedules delivered.
+    size_t buildStreaming(const vector<Course>& courses, const string& semester,
+                          const ScheduleChunkCallback& onChunk, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Like build(), but schedules are generated without their week layout and expand it on demand
+    // through ScheduleSet::weekOf. onChunk, when given, sees every chunk with its source set (e.g. to
+    // persist the option tuples) and can stop the generation by returning false.
+    vector<InformativeSchedule> buildCompact(const vector<Course>& courses, const string& semester,
+                                             const function<bool(const vector<InformativeSchedule>&)>& onChunk = nullptr);
+
+    // Compact build derived from a previous complete one instead of searching again, for when only
+    // one course was added or the single option of a course (e.g. the block times) gained sessions.
+    // Old tuples are remapped, filtered against the changed course and extended with the options of
+    // the added one, giving the same schedules in the same order as buildCompact. Returns false
+    // without touching results for any other change; the caller then runs buildCompact.
+    bool extendCompact(const ScheduleSet& previous, const vector<Course>& courses, const string& semester,
+                       vector<InformativeSchedule>& results,
+                       const function<bool(const vector<InformativeSchedule>&)>& onChunk = nullptr);
+
+    // Set backing the schedules of the last buildCompact or extendCompact call
+    shared_ptr<const ScheduleSet> lastScheduleSet() const { return lastSet; }
+
+    // Returns the k schedules with the lowest objective value, best first (ties keep generation
+    // order). Branch-and-bound: a partial schedule is dropped once a lower bound on every completion
+    // (days used, gaps no remaining course can fill, class time so far) cannot beat the k-th best.
+    vector<InformativeSchedule> buildTopK(const vector<Course>& courses, const string& semester,
+                                          const ScheduleObjective& objective, size_t k);
+
+    // Exact number of valid schedules, found without building any (the schedule limit is not
+    // applied). The last course adds the popcount of its remaining candidates, and subtrees that
+    // leave the same candidates for the remaining courses are counted once. Like build(), an empty
+    // course list has the one empty schedule.
+    uint64_t countSchedules(const vector<Course>& courses);
+
+    // Lays out the sessions of the selected groups by day, sorted by start time. courseInfos[k]
+    // describes the course of selections[k].
+    static vector<ScheduleDay> buildWeek(const vector<const CourseSelection*>& selections,
+                                         const vector<CourseInfo>& courseInfos);
+
+    // Upper bound on the number of generated schedules (0 = no limit)
+    void setMaxSchedules(size_t limit) { maxSchedules = limit; }
+
+    // Number of worker threads used for enumeration (defaults to all hardware threads, 1 = serial)
+    void setThreadCount(unsigned threads) { threadCount = threads > 0 ? threads : 1; }
+
+    // Constraint-propagation mode: visit the course with the fewest remaining compatible options
+    // first and abandon a branch as soon as any unassigned course has none left. Output order is
+    // restored to the regular course order before returning.
+    void setConstraintPropagation(bool enabled) { constraintPropagation = enabled; }
+
+    // Equivalence-class mode: options of a course whose sessions have identical times (e.g. the
+    // same tutorial slot in different rooms) share one search branch and are expanded only when
+    // schedules are materialized. The schedules are the same, but the variants of one time layout
+    // are emitted next to each other rather than in plain option order.
+    void setCollapseEquivalentOptions(bool enabled) { collapseEquivalent = enabled; }
+
+    // Limits enforced by the build variants and buildTopK (countSchedules ignores them). Options
+    // that break a per-session limit are dropped before the search, and a partial schedule is
+    // abandoned once it uses too many days or has gaps no unassigned course can still fill that
+    // break the gap limits. A constrained buildCompact result cannot be extended.
+    void setConstraints(const ScheduleConstraints& limits) { constraints = limits; }
+
+    // Default limit, kept for consumers that collect everything into one vector
+    static constexpr size_t DEFAULT_MAX_SCHEDULES = 50000;
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1000;
+
 private:
-    static mutex courseInfoMapMutex;
-    static unordered_map<int, CourseInfo> courseInfoMap;
+    atomic<int> totalSchedulesGenerated{0};
+    atomic<bool> stopRequested{false};
+    unsigned threadCount = WorkStealingPool::defaultThreadCount();
+    bool constraintPropagation = false;
+    bool collapseEquivalent = false;
+    size_t maxSchedules = DEFAULT_MAX_SCHEDULES;
+    ScheduleConstraints constraints;
 
-    int totalSchedulesGenerated = 0;
-    static string currentSemester;
+    // Semester and course metadata (by course position) of the current generation, set before
+    // the search starts and only read while it runs
+    string currentSemester;
+    vector<CourseInfo> courseInfos;
 
-    // Recursive backtracking function to build all valid schedules
-    void backtrack(int index, const vector<vector<CourseSelection>>& allOptions, vector<CourseSelection>& current,
-            vector<InformativeSchedule>& results);
+    // Option-vs-option compatibility of every course pair, built once per generation
+    CompatibilityMatrix compatibility;
 
-    // Checks if there is a time conflict between two CourseSelections
-    static bool hasConflict(const CourseSelection& a, const CourseSelection& b);
+    // Options of each course grouped by identical session times. In equivalence-class mode the
+    // search runs over one representative per class and members[course][class] lists the original
+    // options (ascending) it stands for.
+    struct OptionClasses {
+        bool active = false;
+        const vector<vector<CourseSelection>>* options = nullptr;
+        vector<vector<CourseSelection>> representatives;
+        vector<vector<vector<int>>> members;
+        vector<vector<int>> classOf;  // [course][option] = class index
+    };
 
-    // Converts a vector of CourseSelections to an InformativeSchedule
-    static InformativeSchedule convertToInformativeSchedule(const vector<CourseSelection>& selections, int index);
+    OptionClasses classes;
 
-    // Helper method to process all sessions in a group and add them to the day schedules
-    static void processGroupSessions(const CourseSelection& selection, const Group* group, const string& sessionType,
-                                     map<int, vector<ScheduleItem>>& daySchedules);
+    static OptionClasses buildOptionClasses(const vector<vector<CourseSelection>>& allOptions);
+
+    // Calls visit with every original option tuple that a tuple of class representatives stands
+    // for, in lexicographic order (the tuple itself outside equivalence-class mode). Returns false
+    // as soon as visit does.
+    bool forEachVariant(const vector<int>& chosen, const function<bool(const vector<int>&)>& visit) const;
+
+    // Options the delivered tuples index into
+    const vector<vector<CourseSelection>>& outputOptions(const vector<vector<CourseSelection>>& searchOptions) const {
+        return classes.active ? *classes.options : searchOptions;
+    }
+
+    // Partial schedule of one search path. chosen[k] is the option picked for course k (-1 while
+    // unassigned) and candidates[d][k] holds the options of course k still compatible with every
+    // option chosen above depth d. metrics holds the sessions of the chosen options.
+    struct SearchState {
+        vector<int> chosen;
+        vector<vector<OptionBitset>> candidates;
+        MetricsAccumulator metrics;
+    };
+
+    // Sessions every option of a course could add, per searched course, for the gap limits
+    vector<WeekMask> constraintCoverage;
+
+    // Drops the options with a session on a forbidden day or outside the allowed hours
+    void removeExcludedOptions(vector<vector<CourseSelection>>& allOptions) const;
+
+    // Prepares constraintCoverage for a search over the given options
+    void prepareConstraints(const vector<vector<CourseSelection>>& searchOptions);
+
+    // False once the partial schedule of the state breaks the day limit, or has a gap that breaks
+    // the gap limits and that no unassigned course can still fill or split. Exact for a complete
+    // schedule.
+    bool withinConstraints(const SearchState& state) const;
+
+    // Results of one search task: materialized schedules when courses are visited in order, or the
+    // lexicographically smallest option tuples (bounded max-heap) when the order is dynamic
+    struct SearchOutput {
+        size_t task = 0;
+        vector<InformativeSchedule> schedules;
+        vector<vector<int>> scheduleTuples;
+        priority_queue<vector<int>> tuples;
+    };
+
+    // Chunk consumer that also receives the option tuple (in course order) of every schedule
+    using TupleChunkCallback = function<bool(vector<InformativeSchedule>& chunk, vector<vector<int>>& tuples)>;
+
+    // Ordered hand-off of the task buffers to the consumer. Only the task at the head may deliver;
+    // later tasks wait once their buffer is full and park it when they finish, and tasks may not
+    // start more than `window` positions past the head. Full chunks are queued in order and passed
+    // to the consumer outside streamMutex by one emitting thread at a time.
+    struct ScheduleStream {
+        const TupleChunkCallback* onChunk = nullptr;
+        string semester;
+        ScheduleId ids;
+        size_t chunkSize = DEFAULT_CHUNK_SIZE;
+        bool keepTuples = false;
+        size_t window = 1;
+        size_t delivered = 0;
+        size_t emitted = 0;
+        vector<InformativeSchedule> pending;
+        vector<vector<int>> pendingTuples;
+        deque<pair<vector<InformativeSchedule>, vector<vector<int>>>> ready;
+        bool emitting = false;
+        bool consumerStopped = false;
+        static constexpr size_t MAX_READY_CHUNKS = 4;
+
+        mutex streamMutex;
+        condition_variable chunkEmitted;
+        condition_variable headAdvanced;
+        size_t headTask = 0;
+        vector<bool> taskFinished;
+        vector<SearchOutput>* outputs = nullptr;
+    };
+
+    ScheduleStream stream;
+
+    shared_ptr<const ScheduleSet> lastSet;
 
-    // Helper method to build course info map
-    static void buildCourseInfoMap(const vector<Course>& courses);
+    // Consumer of buildCompact/extendCompact: records the option tuple of each schedule in the set
+    // and links the schedule to it
+    static TupleChunkCallback compactSink(const shared_ptr<ScheduleSet>& set, vector<InformativeSchedule>& results,
+                                          const function<bool(const vector<InformativeSchedule>&)>& onChunk);
 
-    // Get course name from courseInfoMap
-    static string getCourseNameById(int courseId);
+    // Resets the stream for a new generation
+    void openStream(const TupleChunkCallback& onChunk, const string& semester, size_t chunkSize, bool keepTuples);
+    void closeStream();
 
-    // Get course raw id from courseInfoMap
-    static string getCourseRawIdById(int courseId);
+    // Shared body of the build variants; allOptions receives the generated options, which the
+    // delivered tuples index into
+    size_t generate(const vector<Course>& courses, const string& semester, vector<vector<CourseSelection>>& allOptions,
+                    const TupleChunkCallback& onChunk, size_t chunkSize, bool keepTuples);
+
+    // Sessions (day, start, end minutes) and class time of one option, for bounding in buildTopK
+    struct OptionProfile {
+        vector<array<int, 3>> sessions;
+        int classTime = 0;
+    };
+
+    struct TopKEntry {
+        double value;
+        vector<int> tuple;
+        InformativeSchedule schedule;
+
+        bool operator<(const TopKEntry& other) const {
+            return value < other.value || (value == other.value && tuple < other.tuple);
+        }
+    };
+
+    struct TopKSearch {
+        const ScheduleObjective* objective = nullptr;
+        size_t k = 0;
+
+        // Bounds that depend on the order of a day's sessions (gaps, latest end, span) are only used
+        // when every session is on the slot grid and no option overlaps itself
+        bool orderedTimes = true;
+        vector<vector<OptionProfile>> profiles;
+        vector<WeekMask> remainingCoverage;     // [d] = every session of courses d..n-1
+        vector<int> remainingMinClassTime;      // [d] = cheapest class time of courses d..n-1
+
+        priority_queue<TopKEntry> best;
+        size_t nodes = 0;
+        size_t pruned = 0;
+    };
+
+    // Depth-first branch-and-bound over the courses in order
+    void searchTopK(size_t depth, const vector<vector<CourseSelection>>& allOptions, SearchState& state,
+                    TopKSearch& search);
+
+    // Lower bound on the objective of every completion of the partial schedule (courses < depth)
+    static double lowerBound(const TopKSearch& search, const MetricsAccumulator& metrics, size_t depth);
+
+    // Completions counted per depth, keyed by the candidate words of the courses from that depth on
+    using CountMemo = vector<map<vector<uint64_t>, uint64_t>>;
+    static constexpr size_t MAX_COUNT_MEMO_ENTRIES = 1 << 16;
+
+    // Number of valid completions of the courses from depth on, visited in course order
+    uint64_t countFrom(size_t depth, SearchState& state, CountMemo& memo) const;
+
+    SearchState makeSearchState(const vector<vector<CourseSelection>>& allOptions) const;
+
+    // Picks the course to assign at the given depth
+    size_t nextCourse(const SearchState& state, size_t depth) const;
+
+    // Selects an option for a course and narrows the candidate sets of the unassigned courses.
+    // Returns false when forward checking finds an unassigned course with no options left.
+    bool choose(SearchState& state, size_t depth, size_t course, size_t option) const;
+
+    // Collects the (course, option) choices of every live search node at splitDepth, in DFS order
+    void collectPrefixes(SearchState& state, size_t depth, size_t splitDepth,
+                         vector<pair<size_t, size_t>>& prefix, vector<vector<pair<size_t, size_t>>>& prefixes) const;
+
+    // Splits the search tree at the first course levels and enumerates the subtrees on a
+    // work-stealing pool; task buffers are streamed in DFS order to match the serial output
+    void enumerateParallel(const vector<vector<CourseSelection>>& allOptions);
+
+    // Blocks a task until it is within the start window of the head task
+    void waitForTurn(size_t task);
+
+    // Hands a task buffer to the stream: delivered right away by the head task, otherwise held
+    // until the task reaches the head (full buffer) or parked for the head to deliver (finished)
+    void flushOutput(SearchOutput& output, bool finished);
+
+    // Ordering part of flushOutput, run under streamMutex
+    void deliverOutput(SearchOutput& output, bool finished);
+
+    // Numbers the schedules of a buffer and moves them into the pending chunk, queueing every full
+    // chunk and stopping the search at the limit. Requires streamMutex; call emitReady after unlocking.
+    void deliverLocked(vector<InformativeSchedule>& schedules, vector<vector<int>>& tuples);
+
+    // Queues the pending chunk for the consumer. Requires streamMutex.
+    void queuePendingLocked();
+
+    // Passes the queued chunks to the consumer without holding streamMutex. Only one thread emits at
+    // a time so chunks keep their order; the others return, or wait while the queue is full.
+    void emitReady();
+
+    // Stops the search and wakes every task waiting on the stream
+    void requestStop();
+
+    // Recursive backtracking function to build all valid schedules
+    void backtrack(int depth, const vector<vector<CourseSelection>>& allOptions, SearchState& state,
+            SearchOutput& output);
+
+    // Materializes option tuples (in course order) into schedules and streams them in tuple order
+    void materializeTuples(const vector<vector<int>>& tuples, const vector<vector<CourseSelection>>& allOptions);
+
+    // Converts a vector of CourseSelections to an InformativeSchedule
+    // Metrics come from the accumulator of the search path when given, otherwise from the selections.
+    // Without withWeek the week layout is left empty (compact schedules expand it from their tuple).
+    InformativeSchedule convertToInformativeSchedule(const vector<const CourseSelection*>& selections, int index,
+                                                     const MetricsAccumulator* metrics = nullptr,
+                                                     bool withWeek = true) const;
+
+    // Helper method to process all sessions in a group and add them to the day schedules
+    static void processGroupSessions(const CourseInfo& courseInfo, const Group* group, const InternedString& sessionType,
+                                     array<vector<pair<int, ScheduleItem>>, 8>& daySchedules);
 
-    // Calculate metadata fields of a given schedule
-    static void calculateScheduleMetrics(InformativeSchedule& schedule);
+    // Sets the semester and course metadata used by convertToInformativeSchedule
+    void prepareGeneration(const vector<Course>& courses, const string& semester);
 
-    static string generateUniqueScheduleId(const string& semester, int index);
+    // Calculate metadata fields of a given schedule, from the search path's accumulated sessions or
+    // from the selections themselves
+    static void calculateScheduleMetrics(InformativeSchedule& schedule, const MetricsAccumulator& metrics);
+    static void calculateScheduleMetrics(InformativeSchedule& schedule, const vector<const CourseSelection*>& selections);
 };
 
 #endif // SCHEDULE_BUILDER_H
\ No newline at end of file
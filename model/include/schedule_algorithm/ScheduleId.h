@@ -0,0 +1,96 @@
+#ifndef SCHEDULE_ID_H
+#define SCHEDULE_ID_H
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+
+using namespace std;
+
+// Unique schedule IDs of one generation: "<semester>_<session>_<index>", where the session is
+// drawn once per generation and the index is the schedule's position in it. The same pair packs
+// into a 64-bit key (session in the high half, index in the low half) for integer lookups.
+class ScheduleId {
+public:
+    ScheduleId() = default;
+
+    // Starts a new generation. Sessions count up within a run from a random seed, and the database
+    // moves the count past the sessions it already stores (reserveSessionsThrough), so a stored
+    // session is never reused; without the database, runs only differ by their seed.
+    explicit ScheduleId(const string& semester) : session(nextSession()) {
+        static const char HEX[] = "0123456789abcdef";
+
+        prefix = semester + "_";
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            prefix += HEX[(session >> shift) & 0xF];
+        }
+        prefix += "_";
+    }
+
+    string idOf(int index) const { return prefix + to_string(index); }
+
+    uint64_t keyOf(int index) const {
+        return (uint64_t(session) << 32) | static_cast<uint32_t>(index);
+    }
+
+    // Later generations of this run use sessions above the given one
+    static void reserveSessionsThrough(uint32_t session) {
+        if (session == UINT32_MAX) return;
+
+        uint32_t current = counter().load();
+        while (current <= session && !counter().compare_exchange_weak(current, session + 1)) {
+        }
+    }
+
+    // Key of an ID in the format above; false for IDs in any other format
+    static bool parseKey(const string& uniqueId, uint64_t& key) {
+        size_t indexSeparator = uniqueId.rfind('_');
+        if (indexSeparator == string::npos || indexSeparator < 9 || uniqueId[indexSeparator - 9] != '_') {
+            return false;
+        }
+
+        uint64_t session = 0;
+        for (size_t i = indexSeparator - 8; i < indexSeparator; i++) {
+            char c = uniqueId[i];
+            int digit = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (digit < 0) return false;
+            session = (session << 4) | digit;
+        }
+
+        uint64_t index = 0;
+        if (indexSeparator + 1 == uniqueId.size() || uniqueId.size() - indexSeparator - 1 > 10) return false;
+        for (size_t i = indexSeparator + 1; i < uniqueId.size(); i++) {
+            if (uniqueId[i] < '0' || uniqueId[i] > '9') return false;
+            index = index * 10 + (uniqueId[i] - '0');
+        }
+        if (index > UINT32_MAX) return false;
+
+        key = (session << 32) | index;
+        return true;
+    }
+
+private:
+    uint32_t session = 0;
+    string prefix;
+
+    static atomic<uint32_t>& counter() {
+        static atomic<uint32_t> sessions([] {
+            random_device device;
+            uint64_t clock = chrono::high_resolution_clock::now().time_since_epoch().count();
+            return static_cast<uint32_t>(device() ^ clock ^ (clock >> 32));
+        }());
+        return sessions;
+    }
+
+    // Session 0 is skipped so the first schedule's key is never 0 (no key)
+    static uint32_t nextSession() {
+        uint32_t session = counter()++;
+        return session != 0 ? session : counter()++;
+    }
+};
+
+#endif //SCHEDULE_ID_H
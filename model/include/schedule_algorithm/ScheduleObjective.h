@@ -0,0 +1,127 @@
+#ifndef SCHEDULE_OBJECTIVE_H
+#define SCHEDULE_OBJECTIVE_H
+
+#pragma once
+
+#include "model_interfaces.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Numeric metrics filled in by ScheduleBuilder::calculateScheduleMetrics
+enum class ScheduleMetric {
+    AMOUNT_DAYS,
+    AMOUNT_GAPS,
+    GAPS_TIME,
+    AVG_START,
+    AVG_END,
+    EARLIEST_START,
+    LATEST_END,
+    LONGEST_GAP,
+    TOTAL_CLASS_TIME,
+    CONSECUTIVE_DAYS,
+    MAX_DAILY_HOURS,
+    MIN_DAILY_HOURS,
+    AVG_DAILY_HOURS,
+    MAX_DAILY_GAPS,
+    AVG_GAP_LENGTH,
+    SCHEDULE_SPAN,
+    COMPACTNESS_RATIO
+};
+
+struct ObjectiveTerm {
+    ScheduleMetric metric;
+    double weight = 1.0;  // negative to prefer higher values
+};
+
+// Weighted sum of schedule metrics; lower values are better
+struct ScheduleObjective {
+    vector<ObjectiveTerm> terms;
+
+    ScheduleObjective() = default;
+    ScheduleObjective(ScheduleMetric metric, double weight = 1.0) : terms{{metric, weight}} {}
+    ScheduleObjective(const vector<ObjectiveTerm>& terms) : terms(terms) {}
+
+    double evaluate(const InformativeSchedule& schedule) const {
+        double value = 0.0;
+        for (const auto& term : terms) {
+            value += term.weight * metricValue(schedule, term.metric);
+        }
+        return value;
+    }
+
+    static double metricValue(const InformativeSchedule& schedule, ScheduleMetric metric) {
+        switch (metric) {
+            case ScheduleMetric::AMOUNT_DAYS: return schedule.amount_days;
+            case ScheduleMetric::AMOUNT_GAPS: return schedule.amount_gaps;
+            case ScheduleMetric::GAPS_TIME: return schedule.gaps_time;
+            case ScheduleMetric::AVG_START: return schedule.avg_start;
+            case ScheduleMetric::AVG_END: return schedule.avg_end;
+            case ScheduleMetric::EARLIEST_START: return schedule.earliest_start;
+            case ScheduleMetric::LATEST_END: return schedule.latest_end;
+            case ScheduleMetric::LONGEST_GAP: return schedule.longest_gap;
+            case ScheduleMetric::TOTAL_CLASS_TIME: return schedule.total_class_time;
+            case ScheduleMetric::CONSECUTIVE_DAYS: return schedule.consecutive_days;
+            case ScheduleMetric::MAX_DAILY_HOURS: return schedule.max_daily_hours;
+            case ScheduleMetric::MIN_DAILY_HOURS: return schedule.min_daily_hours;
+            case ScheduleMetric::AVG_DAILY_HOURS: return schedule.avg_daily_hours;
+            case ScheduleMetric::MAX_DAILY_GAPS: return schedule.max_daily_gaps;
+            case ScheduleMetric::AVG_GAP_LENGTH: return schedule.avg_gap_length;
+            case ScheduleMetric::SCHEDULE_SPAN: return schedule.schedule_span;
+            case ScheduleMetric::COMPACTNESS_RATIO: return schedule.compactness_ratio;
+        }
+        return 0.0;
+    }
+
+    // Largest value a metric can take, used to bound terms with a negative weight
+    static double metricUpperBound(ScheduleMetric metric) {
+        switch (metric) {
+            case ScheduleMetric::AMOUNT_DAYS:
+            case ScheduleMetric::CONSECUTIVE_DAYS: return 7;
+            case ScheduleMetric::AMOUNT_GAPS: return 7 * (24 * 60 / 30);
+            case ScheduleMetric::MAX_DAILY_GAPS: return 24 * 60 / 30;
+            case ScheduleMetric::MAX_DAILY_HOURS:
+            case ScheduleMetric::MIN_DAILY_HOURS:
+            case ScheduleMetric::AVG_DAILY_HOURS: return 24;
+            case ScheduleMetric::GAPS_TIME:
+            case ScheduleMetric::TOTAL_CLASS_TIME: return 7 * 24 * 60;
+            case ScheduleMetric::COMPACTNESS_RATIO: return 7.0;  // class time of up to 7 days over one span
+            default: return 24 * 60;
+        }
+    }
+
+    // Maps the metric field names used by the sorting and filtering UI
+    static bool metricFromName(const string& name, ScheduleMetric& metric) {
+        static const vector<pair<string, ScheduleMetric>> names = {
+                {"amount_days", ScheduleMetric::AMOUNT_DAYS},
+                {"amount_gaps", ScheduleMetric::AMOUNT_GAPS},
+                {"gaps_time", ScheduleMetric::GAPS_TIME},
+                {"avg_start", ScheduleMetric::AVG_START},
+                {"avg_end", ScheduleMetric::AVG_END},
+                {"earliest_start", ScheduleMetric::EARLIEST_START},
+                {"latest_end", ScheduleMetric::LATEST_END},
+                {"longest_gap", ScheduleMetric::LONGEST_GAP},
+                {"total_class_time", ScheduleMetric::TOTAL_CLASS_TIME},
+                {"consecutive_days", ScheduleMetric::CONSECUTIVE_DAYS},
+                {"max_daily_hours", ScheduleMetric::MAX_DAILY_HOURS},
+                {"min_daily_hours", ScheduleMetric::MIN_DAILY_HOURS},
+                {"avg_daily_hours", ScheduleMetric::AVG_DAILY_HOURS},
+                {"max_daily_gaps", ScheduleMetric::MAX_DAILY_GAPS},
+                {"avg_gap_length", ScheduleMetric::AVG_GAP_LENGTH},
+                {"schedule_span", ScheduleMetric::SCHEDULE_SPAN},
+                {"compactness_ratio", ScheduleMetric::COMPACTNESS_RATIO}
+        };
+
+        for (const auto& entry : names) {
+            if (entry.first == name) {
+                metric = entry.second;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+#endif //SCHEDULE_OBJECTIVE_H
@@ -0,0 +1,80 @@
+#ifndef SCHEDULE_SET_H
+#define SCHEDULE_SET_H
+
+#include "model_interfaces.h"
+#include "inner_structs.h"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+// Backing store of compactly generated schedules: the courses and options of one build plus one
+// option index per course for every schedule. Schedules hold a shared pointer to their set and
+// only expand their week layout when it is asked for.
+class ScheduleSet {
+public:
+    explicit ScheduleSet(const vector<Course>& courses);
+
+    // Set read back from storage, which keeps the option weeks (keyed by course position << 32 |
+    // option index) instead of the courses; a schedule's week is joined when it is asked for
+    ScheduleSet(size_t courseCount, map<uint64_t, vector<ScheduleDay>> optionWeeks);
+
+    // Options point into the set's own courses, so the set is never copied
+    ScheduleSet(const ScheduleSet&) = delete;
+    ScheduleSet& operator=(const ScheduleSet&) = delete;
+
+    size_t size() const {
+        lock_guard<mutex> lock(tuplesMutex);
+        return scheduleCount;
+    }
+
+    // Week layout of a schedule: its own week, or the expansion of its option tuple
+    static vector<ScheduleDay> weekOf(const InformativeSchedule& schedule);
+
+    // Copy of the schedule with the week filled in, for consumers that need the full layout
+    static InformativeSchedule expanded(const InformativeSchedule& schedule);
+
+    // Option layout, for storage that keeps option tuples instead of weeks
+    size_t courseCount() const { return options.size(); }
+    vector<uint32_t> tupleOf(size_t position) const;
+
+    // Items of one course's option alone; joinOptionWeeks rebuilds a schedule's week from the
+    // option weeks of its tuple, given in course order
+    vector<ScheduleDay> optionWeek(size_t course, uint32_t option) const;
+    static vector<ScheduleDay> joinOptionWeeks(const vector<const vector<ScheduleDay>*>& optionWeeks);
+
+    bool fromStorage() const { return stored; }
+
+    // Adds a tuple to a set read back from storage; false if the tuple does not fit its option weeks
+    bool appendStored(const vector<uint32_t>& tuple, size_t& position);
+
+private:
+    friend class ScheduleBuilder;
+
+    vector<Course> courses;
+    vector<CourseInfo> courseInfo;  // by course position
+    vector<vector<CourseSelection>> options;  // one empty list per course in a stored set
+
+    bool stored = false;
+    map<uint64_t, vector<ScheduleDay>> storedWeeks;
+
+    // options.size() entries per schedule. Stored schedules can be read (e.g. by the database
+    // writer) while generation still appends, so tuples are only touched under the mutex.
+    vector<uint32_t> tuples;
+    size_t scheduleCount = 0;
+    mutable mutex tuplesMutex;
+
+    // Every valid schedule was generated (not cut short by the limit, the consumer or generation
+    // constraints), so the set can be extended by ScheduleBuilder::extendCompact
+    bool complete = false;
+
+    // Stores the option tuple of a schedule and returns its position
+    size_t append(const vector<int>& tuple);
+
+    vector<ScheduleDay> expandWeek(size_t position) const;
+};
+
+#endif // SCHEDULE_SET_H
@@ -11,5 +11,22 @@ class TimeUtils {
 public:
     static int toMinutes(const std::string& time);
     static bool isOverlap(const Session* s1, const Session* s2);
+
+    // Integer overlap check on pre-parsed [start, end) intervals
+    static bool isOverlap(int day1, int start1, int end1, int day2, int start2, int end2) {
+        return day1 == day2 && start1 < end2 && start2 < end1;
+    }
+
+    // Fill the pre-parsed minute fields from the display strings
+    static bool compileSession(Session& session);
+    static void compileCourse(Course& course);
+
+    // Pre-parsed start/end minutes, falling back to string parsing for uncompiled sessions
+    static int startMinutes(const Session& session) {
+        return session.start_minutes >= 0 ? session.start_minutes : toMinutes(session.start_time);
+    }
+    static int endMinutes(const Session& session) {
+        return session.end_minutes >= 0 ? session.end_minutes : toMinutes(session.end_time);
+    }
 };
-#endif // TIME_UTILS_H
\ No newline at end of file
+#endif // TIME_UTILS_H
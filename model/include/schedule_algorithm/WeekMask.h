@@ -0,0 +1,82 @@
+#ifndef WEEK_MASK_H
+#define WEEK_MASK_H
+
+#pragma once
+
+#include "model_interfaces.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Occupancy bitmap of the week: 7 days x 288 five-minute slots packed into 64-bit words
+struct WeekMask {
+    static constexpr int SLOT_MINUTES = 5;
+    static constexpr int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;
+    static constexpr int WORDS = (7 * SLOTS_PER_DAY + 63) / 64;
+
+    std::array<uint64_t, WORDS> bits{};
+
+    // False once a session could not be represented on the slot grid (unaligned, invalid day or
+    // reversed range). Intersections involving an inexact mask must be confirmed session by session.
+    bool exact = true;
+
+    void addSession(const Session& session) {
+        int start, end;
+        try {
+            start = TimeUtils::startMinutes(session);
+            end = TimeUtils::endMinutes(session);
+        } catch (const std::exception&) {
+            exact = false;
+            return;
+        }
+
+        if (session.day_of_week < 1 || session.day_of_week > 7 || start >= end ||
+            start % SLOT_MINUTES != 0 || end % SLOT_MINUTES != 0) {
+            exact = false;
+            return;
+        }
+
+        int dayOffset = (session.day_of_week - 1) * SLOTS_PER_DAY;
+        for (int slot = dayOffset + start / SLOT_MINUTES; slot < dayOffset + end / SLOT_MINUTES; slot++) {
+            bits[slot / 64] |= (uint64_t(1) << (slot % 64));
+        }
+    }
+
+    void addGroup(const Group* group) {
+        if (!group) return;
+        for (const auto& session : group->sessions) {
+            addSession(session);
+        }
+    }
+
+    bool intersects(const WeekMask& other) const {
+        for (int i = 0; i < WORDS; i++) {
+            if (bits[i] & other.bits[i]) return true;
+        }
+        return false;
+    }
+
+    // True if any slot touching [startMinutes, endMinutes) on the given day is occupied
+    bool intersectsRange(int day, int startMinutes, int endMinutes) const {
+        if (day < 1 || day > 7 || startMinutes >= endMinutes) return false;
+
+        int dayOffset = (day - 1) * SLOTS_PER_DAY;
+        int firstSlot = dayOffset + max(0, startMinutes) / SLOT_MINUTES;
+        int lastSlot = dayOffset + min(SLOTS_PER_DAY, (endMinutes + SLOT_MINUTES - 1) / SLOT_MINUTES);
+        for (int slot = firstSlot; slot < lastSlot; slot++) {
+            if (bits[slot / 64] & (uint64_t(1) << (slot % 64))) return true;
+        }
+        return false;
+    }
+
+    void merge(const WeekMask& other) {
+        for (int i = 0; i < WORDS; i++) {
+            bits[i] |= other.bits[i];
+        }
+        exact = exact && other.exact;
+    }
+};
+
+#endif //WEEK_MASK_H
@@ -0,0 +1,45 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include "logger.h"
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+
+using namespace std;
+
+// Fixed-size pool that runs a batch of independent tasks. Tasks are dealt round-robin to per-worker
+// deques; each worker drains its own deque front to back and, once empty, steals the oldest task of
+// another worker. Tasks therefore start in roughly ascending order, which ordered consumers rely on.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned threadCount);
+
+    // Runs every task to completion and returns once all workers have joined
+    void run(const vector<function<void()>>& tasks);
+
+    static unsigned defaultThreadCount();
+
+private:
+    struct WorkerQueue {
+        mutex queueMutex;
+        deque<size_t> taskIndices;
+    };
+
+    unsigned threadCount;
+
+    // Takes the next task from the front of the worker's own queue
+    static bool popLocal(WorkerQueue& queue, size_t& taskIndex);
+
+    // Takes a task from the front of another worker's queue
+    static bool steal(vector<unique_ptr<WorkerQueue>>& queues, unsigned thief, size_t& taskIndex);
+
+    static void workerLoop(vector<unique_ptr<WorkerQueue>>& queues, unsigned workerId,
+                           const vector<function<void()>>& tasks);
+};
+
+#endif // WORK_STEALING_POOL_H
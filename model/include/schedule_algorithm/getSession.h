@@ -12,79 +12,11 @@ inline vector<const Session*> getSessions(const CourseSelection& selection) {
     vector<const Session*> sessions;
 
     try {
-        // Add sessions from lecture group
-        if (selection.lectureGroup) {
-            for (const auto& session : selection.lectureGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from tutorial group
-        if (selection.tutorialGroup) {
-            for (const auto& session : selection.tutorialGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from lab group
-        if (selection.labGroup) {
-            for (const auto& session : selection.labGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from block group
-        if (selection.blockGroup) {
-            for (const auto& session : selection.blockGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from departmental group
-        if (selection.departmentalGroup) {
-            for (const auto& session : selection.departmentalGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from reinforcement group
-        if (selection.reinforcementGroup) {
-            for (const auto& session : selection.reinforcementGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from guidance group
-        if (selection.guidanceGroup) {
-            for (const auto& session : selection.guidanceGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from colloquium group
-        if (selection.colloquiumGroup) {
-            for (const auto& session : selection.colloquiumGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from registration group
-        if (selection.registrationGroup) {
-            for (const auto& session : selection.registrationGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
-
-        // Add sessions from thesis group
-        if (selection.thesisGroup) {
-            for (const auto& session : selection.thesisGroup->sessions) {
-                sessions.push_back(&session);
-            }
-        }
+        for (const auto& slot : GROUP_TYPE_SLOTS) {
+            const Group* group = selection.groups[slot.slot];
+            if (!group) continue;
 
-        // Add sessions from project group
-        if (selection.projectGroup) {
-            for (const auto& session : selection.projectGroup->sessions) {
+            for (const auto& session : group->sessions) {
                 sessions.push_back(&session);
             }
         }
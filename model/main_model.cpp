@@ -6,6 +6,8 @@ vector<string> Model::lastFilteredUniqueIds;
 vector<Course> Model::lastGeneratedCourses;
 vector<InformativeSchedule> Model::lastGeneratedSchedules;
 map<string, vector<InformativeSchedule>> Model::semesterSchedules;
+mutex Model::scheduleSetsMutex;
+map<string, shared_ptr<const ScheduleSet>> Model::lastScheduleSets;
 
 
 // main model menu
@@ -78,8 +80,9 @@ void* Model::executeOperation(ModelOperation operation, const void* data, const
 
             case ModelOperation::GENERATE_SCHEDULES: {
                 if (data) {
-                    const auto* courses = static_cast<const vector<Course>*>(data);
-                    auto* schedules = new vector<InformativeSchedule>(generateSchedules(*courses, path));
+                    const auto* request = static_cast<const ScheduleGenerationRequest*>(data);
+                    auto* schedules = new vector<InformativeSchedule>(
+                            generateSchedules(request->courses, path, request->constraints));
 
                     if (!schedules->empty()) {
                         lock_guard<mutex> lock(dataAccessMutex);
@@ -93,6 +96,16 @@ void* Model::executeOperation(ModelOperation operation, const void* data, const
                 }
             }
 
+            case ModelOperation::COUNT_SCHEDULES: {
+                if (data) {
+                    const auto* courses = static_cast<const vector<Course>*>(data);
+                    return new uint64_t(countSchedules(*courses));
+                } else {
+                    Logger::get().logError("No courses were found for counting, aborting...");
+                    return nullptr;
+                }
+            }
+
             case ModelOperation::SAVE_SCHEDULE: {
                 if (data && !path.empty()) {
                     const auto* schedule = static_cast<const InformativeSchedule*>(data);
@@ -436,7 +449,8 @@ vector<string> Model::validateCourses(const vector<Course>& courses) {
 
 // Manage schedules
 
-vector<InformativeSchedule> Model::generateSchedules(const vector<Course>& userInput, const string& semester) {
+vector<InformativeSchedule> Model::generateSchedules(const vector<Course>& userInput, const string& semester,
+                                                     const ScheduleConstraints& constraints) {
     if (userInput.empty() || userInput.size() > 8) {
         Logger::get().logError("invalid amount of courses (" + std::to_string(userInput.size()) + "), aborting...");
         return {};
@@ -445,76 +459,109 @@ vector<InformativeSchedule> Model::generateSchedules(const vector<Course>& userI
     Logger::get().logInfo("Generating schedules for " + std::to_string(userInput.size()) +
                           " courses in semester " + semester);
 
+    // Manual courses and block times arrive from the controller without pre-parsed minutes
+    vector<Course> compiledInput = userInput;
+    for (auto& course : compiledInput) {
+        TimeUtils::compileCourse(course);
+    }
+
+    // Groups that only differ by room are searched once and expanded when materialized
     ScheduleBuilder builder;
+    builder.setCollapseEquivalentOptions(true);
+    builder.setConstraints(constraints);
     vector<InformativeSchedule> schedules;
 
+    // Chunks are handed to the background writer as they are generated, so the schedules are
+    // returned without waiting for the database
+    auto& writer = ScheduleDatabaseWriter::getInstance();
+    bool persisting = writer.initializeSession();
+    if (!persisting) {
+        Logger::get().logWarning("Database not available for saving schedules");
+    }
+
     try {
-        schedules = builder.build(userInput, semester);
+        // The returned schedules keep only their metrics and option tuples and expand their week
+        // when displayed or exported
+        auto saveChunk = [&](const vector<InformativeSchedule>& chunk) {
+            if (persisting) {
+                writer.writeSchedules(chunk);
+            }
+            return true;
+        };
+
+        shared_ptr<const ScheduleSet> previous;
+        {
+            lock_guard<mutex> lock(scheduleSetsMutex);
+            auto it = lastScheduleSets.find(semester);
+            if (it != lastScheduleSets.end()) {
+                previous = it->second;
+            }
+        }
+
+        // Adding a course or block times only filters and extends the previous result
+        if (!previous || !builder.extendCompact(*previous, compiledInput, semester, schedules, saveChunk)) {
+            schedules = builder.buildCompact(compiledInput, semester, saveChunk);
+        }
+
+        // A constrained result cannot be extended, so the last unconstrained one is kept
+        if (!constraints.active()) {
+            lock_guard<mutex> lock(scheduleSetsMutex);
+            lastScheduleSets[semester] = builder.lastScheduleSet();
+        }
 
         if (!schedules.empty()) {
             Logger::get().logInfo("Generated " + std::to_string(schedules.size()) +
                                   " schedules for semester " + semester);
-
-            saveSchedulesToDB(schedules, semester);
         }
 
     } catch (const std::exception& e) {
         Logger::get().logError("Exception during schedule generation: " + string(e.what()));
     }
 
+    if (persisting) {
+        writer.finalizeSession();
+    }
+
     return schedules;
 }
 
+uint64_t Model::countSchedules(const vector<Course>& userInput) {
+    if (userInput.empty() || userInput.size() > 8) {
+        Logger::get().logError("invalid amount of courses (" + std::to_string(userInput.size()) + "), aborting...");
+        return 0;
+    }
+
+    vector<Course> compiledInput = userInput;
+    for (auto& course : compiledInput) {
+        TimeUtils::compileCourse(course);
+    }
+
+    // Exact count so the caller can decide how to run the generation before starting it
+    ScheduleBuilder builder;
+    return builder.countSchedules(compiledInput);
+}
+
 void Model::saveSchedule(const InformativeSchedule& infoSchedule, const string& path) {
-    bool status = saveScheduleToCsv(path, infoSchedule);
+    bool status = saveScheduleToCsv(path, ScheduleSet::expanded(infoSchedule));
     string message = status ? "Schedule saved to CSV: " + path : "An error has occurred, unable to save schedule as csv";
     Logger::get().logInfo(message);
 }
 
 void Model::printSchedule(const InformativeSchedule& infoSchedule) {
-    bool status = printSelectedSchedule(infoSchedule);
+    bool status = printSelectedSchedule(ScheduleSet::expanded(infoSchedule));
     string message = status ? "Schedule sent to printer" : "An error has occurred, unable to print schedule";
     Logger::get().logInfo(message);
 }
 
-bool Model::saveSchedulesToDB(const vector<InformativeSchedule>& schedules, const string& semester) {
-    try {
-        auto& dbIntegration = ModelDatabaseIntegration::getInstance();
-        if (!dbIntegration.isInitialized()) {
-            if (!dbIntegration.initializeDatabase()) {
-                Logger::get().logWarning("Database not available for saving schedules");
-                return false;
-            }
-        }
-
-        auto& db = DatabaseManager::getInstance();
-        if (!db.isConnected()) {
-            Logger::get().logWarning("Database not connected for saving schedules");
-            return false;
-        }
-
-        // Use database manager's thread-safe batch method
-        bool success = dbIntegration.saveSchedulesToDatabase(schedules);
-
-        if (success) {
-            Logger::get().logInfo("Successfully saved " + std::to_string(schedules.size()) +
-                                  " schedules for semester " + semester);
-        } else {
-            Logger::get().logWarning("Failed to save schedules for semester " + semester);
-        }
-
-        return success;
-
-    } catch (const std::exception& e) {
-        Logger::get().logError("Exception saving schedules to database: " + std::string(e.what()));
-        return false;
-    }
-}
-
 BotQueryResponse Model::processClaudeQuery(const BotQueryRequest& request) {
     try {
         Logger::get().logInfo("Model::processClaudeQuery - Processing request for semester: " + request.semester);
 
+        // Filters run against the database, so schedules still being written must land first
+        if (!ScheduleDatabaseWriter::getInstance().waitUntilIdle()) {
+            Logger::get().logWarning("Some generated schedules were not saved; filtering the saved ones");
+        }
+
         BotQueryResponse response = ClaudeAPIClient::ActivateBot(request);
 
         // UPDATED: Handle both unique IDs and schedule indices
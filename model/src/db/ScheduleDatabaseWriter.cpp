@@ -1,18 +1,24 @@
 #include "ScheduleDatabaseWriter.h"
 
+namespace {
+    const char* const WRITER_CONNECTION = "schedulify_writer_connection";
+}
+
 ScheduleDatabaseWriter& ScheduleDatabaseWriter::getInstance() {
     static ScheduleDatabaseWriter instance;
     return instance;
 }
 
 ScheduleDatabaseWriter::~ScheduleDatabaseWriter() {
-    if (sessionActive) {
-        finalizeSession();
+    // Static destruction is too late to close the writer's connection; a thread that was never
+    // stopped is left to the process exit
+    if (writerThread.joinable()) {
+        writerThread.detach();
     }
 }
 
 bool ScheduleDatabaseWriter::initializeSession() {
-    if (sessionActive) {
+    if (getSessionStats().sessionActive) {
         Logger::get().logWarning("Session already active, finalizing previous session");
         finalizeSession();
     }
@@ -26,38 +32,61 @@ bool ScheduleDatabaseWriter::initializeSession() {
             }
         }
 
+        QString path = DatabaseManager::getInstance().databasePath();
+
+        lock_guard<mutex> lock(stateMutex);
+
+        // Batches of an earlier session that are still queued stay counted as queued
+        int stillQueued = sessionStats.queuedSchedules;
         sessionActive = true;
         sessionStats = SessionStats();
         sessionStats.sessionActive = true;
+        sessionStats.queuedSchedules = stillQueued;
         currentBatch.clear();
 
+        if (!writerThread.joinable()) {
+            databasePath = path;
+            stopping = false;
+            writerThread = thread(&ScheduleDatabaseWriter::run, this);
+        }
+
         Logger::get().logInfo("Schedule writing session initialized");
         return true;
 
     } catch (const std::exception& e) {
         Logger::get().logError("Exception initializing schedule writing session: " + std::string(e.what()));
+        lock_guard<mutex> lock(stateMutex);
         resetSession();
         return false;
     }
 }
 
 bool ScheduleDatabaseWriter::writeSchedule(const InformativeSchedule& schedule) {
+    return writeSchedules({schedule});
+}
+
+bool ScheduleDatabaseWriter::writeSchedules(const vector<InformativeSchedule>& schedules) {
+    unique_lock<mutex> lock(stateMutex);
     if (!sessionActive) {
         Logger::get().logError("No active session for schedule writing");
         return false;
     }
 
     try {
-        // Add to current batch
-        currentBatch.push_back(schedule);
-        sessionStats.totalSchedulesWritten++;
+        bool success = true;
+        for (const auto& schedule : schedules) {
+            // Add to current batch; compact schedules come without a week, so only metrics and
+            // the tuple reference are copied
+            currentBatch.push_back(schedule);
+            sessionStats.totalSchedulesWritten++;
 
-        // Write batch if it's full
-        if (currentBatch.size() >= static_cast<size_t>(batchSize)) {
-            return flushBatch();
+            // Queue batch if it's full
+            if (currentBatch.size() >= static_cast<size_t>(batchSize)) {
+                success = queueBatchLocked(lock) && success;
+            }
         }
 
-        return true;
+        return success;
 
     } catch (const std::exception& e) {
         Logger::get().logError("Exception writing schedule: " + std::string(e.what()));
@@ -67,79 +96,208 @@ bool ScheduleDatabaseWriter::writeSchedule(const InformativeSchedule& schedule)
 }
 
 bool ScheduleDatabaseWriter::flushBatch() {
+    unique_lock<mutex> lock(stateMutex);
     if (currentBatch.empty()) {
         return true; // Nothing to flush
     }
 
-    try {
-        if (writeBatchToDatabase()) {
-            sessionStats.successfulWrites += currentBatch.size();
-            currentBatch.clear();
+    return queueBatchLocked(lock);
+}
 
-            // Log progress every 1000 successful writes
-            if (sessionStats.successfulWrites % 1000 == 0) {
-                Logger::get().logInfo("Progress: " + std::to_string(sessionStats.successfulWrites) + " schedules written");
-            }
+bool ScheduleDatabaseWriter::queueBatchLocked(unique_lock<mutex>& lock) {
+    if (!writerThread.joinable() || stopping) {
+        Logger::get().logError("Schedule writer is not running, dropping " + std::to_string(currentBatch.size()) + " schedules");
+        sessionStats.failedWrites += static_cast<int>(currentBatch.size());
+        currentBatch.clear();
+        return false;
+    }
 
-            return true;
-        } else {
-            sessionStats.failedWrites += currentBatch.size();
-            currentBatch.clear(); // Clear batch even on failure to prevent repeated failures
-            return false;
-        }
+    // A full queue holds the producer back until the writer catches up
+    auto batchFits = [&]() {
+        return sessionStats.queuedSchedules == 0 || stopping ||
+               sessionStats.queuedSchedules + currentBatch.size() <= static_cast<size_t>(maxQueuedSchedules);
+    };
+    queueChanged.wait(lock, batchFits);
 
-    } catch (const std::exception& e) {
-        Logger::get().logError("Exception flushing batch: " + std::string(e.what()));
-        sessionStats.failedWrites += currentBatch.size();
+    // The writer was stopped while this batch waited for room
+    if (stopping) {
+        Logger::get().logError("Schedule writer stopped, dropping " + std::to_string(currentBatch.size()) + " schedules");
+        sessionStats.failedWrites += static_cast<int>(currentBatch.size());
         currentBatch.clear();
         return false;
     }
+
+    sessionStats.queuedSchedules += static_cast<int>(currentBatch.size());
+    pendingBatches.push_back(std::move(currentBatch));
+    currentBatch.clear();
+
+    queueChanged.notify_all();
+    return true;
 }
 
 bool ScheduleDatabaseWriter::finalizeSession() {
+    unique_lock<mutex> lock(stateMutex);
     if (!sessionActive) {
         return true; // Nothing to finalize
     }
 
-    try {
-        // Flush any remaining schedules
-        bool success = flushBatch();
+    // Queue any remaining schedules; the writer thread logs the results once they are written
+    bool success = currentBatch.empty() || queueBatchLocked(lock);
 
-        // Update schedule count in set
-        auto& db = DatabaseManager::getInstance();
+    sessionActive = false;
+    sessionStats.sessionActive = false;
+    queueChanged.notify_all();
 
-        // Log session results
-        Logger::get().logInfo("=== SCHEDULE WRITING SESSION COMPLETED ===");
-        Logger::get().logInfo("Total Processed: " + std::to_string(sessionStats.totalSchedulesWritten));
-        Logger::get().logInfo("Successfully Written: " + std::to_string(sessionStats.successfulWrites));
-        Logger::get().logInfo("Failed Writes: " + std::to_string(sessionStats.failedWrites));
+    Logger::get().logInfo("Schedule writing session finalized, " + std::to_string(sessionStats.queuedSchedules) +
+                          " schedules still being written");
+    return success;
+}
 
-        resetSession();
-        return success;
+bool ScheduleDatabaseWriter::waitUntilIdle() {
+    unique_lock<mutex> lock(stateMutex);
 
-    } catch (const std::exception& e) {
-        Logger::get().logError("Exception finalizing session: " + std::string(e.what()));
-        resetSession();
-        return false;
+    // An active session still fills currentBatch, so the table is only complete once it is finalized
+    queueChanged.wait(lock, [&]() {
+        return (!sessionActive && currentBatch.empty() && pendingBatches.empty() && !writing) ||
+               !writerThread.joinable() || stopping;
+    });
+
+    return pendingBatches.empty() && currentBatch.empty() && sessionStats.failedWrites == 0;
+}
+
+void ScheduleDatabaseWriter::shutdown() {
+    stopWriter(false);
+}
+
+void ScheduleDatabaseWriter::cancel() {
+    stopWriter(true);
+}
+
+void ScheduleDatabaseWriter::stopWriter(bool discardQueued) {
+    {
+        lock_guard<mutex> lock(stateMutex);
+        if (!writerThread.joinable()) {
+            return;
+        }
+
+        if (discardQueued) {
+            size_t dropped = currentBatch.size();
+            for (const auto& batch : pendingBatches) {
+                sessionStats.queuedSchedules -= static_cast<int>(batch.size());
+                dropped += batch.size();
+            }
+            if (dropped > 0) {
+                Logger::get().logInfo("Discarding " + std::to_string(dropped) + " queued schedules");
+            }
+            sessionStats.failedWrites += static_cast<int>(dropped);
+            pendingBatches.clear();
+            currentBatch.clear();
+        } else if (!currentBatch.empty()) {
+            // Whatever was handed over is still written before the thread exits
+            sessionStats.queuedSchedules += static_cast<int>(currentBatch.size());
+            pendingBatches.push_back(std::move(currentBatch));
+            currentBatch.clear();
+        }
+        stopping = true;
+        queueChanged.notify_all();
     }
+
+    writerThread.join();
+
+    lock_guard<mutex> lock(stateMutex);
+    stopping = false;
+    resetSession();
 }
 
-bool ScheduleDatabaseWriter::writeBatchToDatabase() {
-    if (currentBatch.empty()) {
+ScheduleDatabaseWriter::SessionStats ScheduleDatabaseWriter::getSessionStats() const {
+    lock_guard<mutex> lock(stateMutex);
+    return sessionStats;
+}
+
+void ScheduleDatabaseWriter::setBatchSize(int size) {
+    lock_guard<mutex> lock(stateMutex);
+    batchSize = size;
+}
+
+void ScheduleDatabaseWriter::setMaxQueuedSchedules(int size) {
+    lock_guard<mutex> lock(stateMutex);
+    maxQueuedSchedules = size;
+    queueChanged.notify_all();
+}
+
+void ScheduleDatabaseWriter::run() {
+    {
+        // Qt connections belong to the thread that opens them, so the writer has its own
+        QSqlDatabase connection = QSqlDatabase::addDatabase("QSQLITE", WRITER_CONNECTION);
+        connection.setDatabaseName(databasePath);
+        connection.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+
+        bool connected = connection.open();
+        if (connected) {
+            // WAL lets the UI and the bot read while batches are being written
+            DatabaseUtils::enableWALMode(connection);
+        } else {
+            Logger::get().logError("Schedule writer failed to open database: " + connection.lastError().text().toStdString());
+        }
+
+        DatabaseScheduleManager schedules(connection);
+
+        unique_lock<mutex> lock(stateMutex);
+        while (true) {
+            queueChanged.wait(lock, [&]() { return stopping || !pendingBatches.empty(); });
+            if (pendingBatches.empty()) {
+                break;
+            }
+
+            vector<InformativeSchedule> batch = std::move(pendingBatches.front());
+            pendingBatches.pop_front();
+            writing = true;
+
+            lock.unlock();
+            bool success = connected && writeBatchToDatabase(schedules, batch);
+            lock.lock();
+
+            writing = false;
+            int previousWrites = sessionStats.successfulWrites;
+            sessionStats.queuedSchedules -= static_cast<int>(batch.size());
+            if (success) {
+                sessionStats.successfulWrites += static_cast<int>(batch.size());
+            } else {
+                sessionStats.failedWrites += static_cast<int>(batch.size());
+            }
+
+            // Log progress every 1000 successful writes
+            if (sessionStats.successfulWrites / 1000 > previousWrites / 1000) {
+                Logger::get().logInfo("Progress: " + std::to_string(sessionStats.successfulWrites) + " schedules written");
+            }
+
+            if (pendingBatches.empty() && !sessionActive) {
+                // Log session results
+                Logger::get().logInfo("=== SCHEDULE WRITING SESSION COMPLETED ===");
+                Logger::get().logInfo("Total Processed: " + std::to_string(sessionStats.totalSchedulesWritten));
+                Logger::get().logInfo("Successfully Written: " + std::to_string(sessionStats.successfulWrites));
+                Logger::get().logInfo("Failed Writes: " + std::to_string(sessionStats.failedWrites));
+            }
+
+            queueChanged.notify_all();
+        }
+        lock.unlock();
+
+        connection.close();
+    }
+
+    QSqlDatabase::removeDatabase(WRITER_CONNECTION);
+}
+
+bool ScheduleDatabaseWriter::writeBatchToDatabase(DatabaseScheduleManager& schedules,
+                                                  const vector<InformativeSchedule>& batch) {
+    if (batch.empty()) {
         return true;
     }
 
     try {
-        auto& db = DatabaseManager::getInstance();
-        if (!db.isConnected()) {
-            Logger::get().logError("Database not connected during batch write");
-            return false;
-        }
-
         // Use simplified bulk insert
-        bool success = db.schedules()->insertSchedules(currentBatch);
-
-        return success;
+        return schedules.insertSchedules(batch);
 
     } catch (const std::exception& e) {
         Logger::get().logError("Exception in batch write: " + std::string(e.what()));
@@ -151,4 +309,4 @@ void ScheduleDatabaseWriter::resetSession() {
     sessionActive = false;
     sessionStats = SessionStats();
     currentBatch.clear();
-}
\ No newline at end of file
+}
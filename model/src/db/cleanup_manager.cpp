@@ -6,6 +6,10 @@ void CleanupManager::performCleanup() {
     }
 
     try {
+        // The writer thread holds its own connection, so it stops before the data is cleared;
+        // schedules still queued would only be deleted again
+        ScheduleDatabaseWriter::getInstance().cancel();
+
         auto& dbIntegration = ModelDatabaseIntegration::getInstance();
         if (dbIntegration.isInitialized()) {
             auto& db = DatabaseManager::getInstance();
@@ -1,4 +1,6 @@
 #include "db_json_helpers.h"
+#include "TimeUtils.h"
+#include "ScheduleSet.h"
 
 string DatabaseJsonHelpers::groupsToJson(const vector<Group>& groups) {
     QJsonArray groupsArray;
@@ -83,6 +85,7 @@ vector<Group> DatabaseJsonHelpers::groupsFromJson(const string& json) {
             session.end_time = sessionObj["end_time"].toString().toStdString();
             session.building_number = sessionObj["building_number"].toString().toStdString();
             session.room_number = sessionObj["room_number"].toString().toStdString();
+            TimeUtils::compileSession(session);
 
             group.sessions.push_back(session);
         }
@@ -97,7 +100,7 @@ string DatabaseJsonHelpers::scheduleToJson(const InformativeSchedule& schedule)
     QJsonObject scheduleObj;
 
     QJsonArray weekArray;
-    for (const auto& day : schedule.week) {
+    for (const auto& day : ScheduleSet::weekOf(schedule)) {
         QJsonObject dayObj;
         dayObj["day"] = QString::fromStdString(day.day);
 
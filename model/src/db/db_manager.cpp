@@ -1,4 +1,26 @@
 #include "db_manager.h"
+#include "ScheduleId.h"
+
+namespace {
+    const char* const MAIN_CONNECTION = "schedulify_connection";
+    const char* const THREAD_CONNECTION_PREFIX = "schedulify_connection_thread_";
+
+    // Wait for the writer's transaction instead of failing with SQLITE_BUSY
+    const char* const BUSY_TIMEOUT_OPTION = "QSQLITE_BUSY_TIMEOUT=5000";
+
+    // Releases a thread's pooled connection on that thread when it exits, QThread or not
+    struct ThreadConnectionRelease {
+        bool pooled = false;
+
+        ~ThreadConnectionRelease() {
+            if (pooled) {
+                DatabaseManager::getInstance().releaseThreadConnection();
+            }
+        }
+    };
+
+    thread_local ThreadConnectionRelease threadConnectionRelease;
+}
 
 class DatabaseRepair {
 public:
@@ -123,16 +145,29 @@ DatabaseManager::~DatabaseManager() {
             fileManager.reset();
             schemaManager.reset();
             isInitialized = false;
+            setConnected(false);
             Logger::get().logInfo("DatabaseManager destroyed after Qt shutdown");
         }
     } catch (const std::exception& e) {}
 }
 
 bool DatabaseManager::isConnected() const {
-    return isInitialized && db.isOpen();
+    lock_guard<mutex> lock(connectionsMutex);
+    return connected;
+}
+
+void DatabaseManager::setConnected(bool open) {
+    lock_guard<mutex> lock(connectionsMutex);
+    connected = open;
+    if (open) {
+        ownerThread = std::this_thread::get_id();
+    }
 }
 
 void DatabaseManager::closeDatabase() {
+    setConnected(false);
+    retireThreadConnections();
+
     // Reset managers before closing database
     courseManager.reset();
     fileManager.reset();
@@ -142,14 +177,14 @@ void DatabaseManager::closeDatabase() {
     if (db.isOpen()) {
         db.close();
     }
-    QSqlDatabase::removeDatabase("schedulify_connection");
+    QSqlDatabase::removeDatabase(MAIN_CONNECTION);
     isInitialized = false;
 }
 
 bool DatabaseManager::insertMetadata(const string& key, const string& value, const string& description) {
     if (!isConnected()) return false;
 
-    QSqlQuery query(db);
+    QSqlQuery query(connection());
     query.prepare(R"(
         INSERT OR REPLACE INTO metadata (key, value, description, updated_at)
         VALUES (?, ?, ?, CURRENT_TIMESTAMP)
@@ -174,7 +209,7 @@ bool DatabaseManager::updateMetadata(const string& key, const string& value) {
 string DatabaseManager::getMetadata(const string& key, const string& defaultValue) {
     if (!isConnected()) return defaultValue;
 
-    QSqlQuery query(db);
+    QSqlQuery query(connection());
     query.prepare("SELECT value FROM metadata WHERE key = ?");
     query.addBindValue(QString::fromStdString(key));
 
@@ -189,7 +224,7 @@ vector<MetadataEntity> DatabaseManager::getAllMetadata() {
     vector<MetadataEntity> metadata;
     if (!isConnected()) return metadata;
 
-    QSqlQuery query("SELECT id, key, value, description, updated_at FROM metadata ORDER BY key", db);
+    QSqlQuery query("SELECT id, key, value, description, updated_at FROM metadata ORDER BY key", connection());
 
     while (query.next()) {
         MetadataEntity entity;
@@ -209,10 +244,10 @@ bool DatabaseManager::clearAllData() {
 
     DatabaseTransaction transaction(*this);
 
-    QStringList tables = {"schedule", "schedule_set", "course", "file", "metadata"};
+    QStringList tables = {"schedule", "schedule_option", "schedule_generation", "course", "file", "metadata"};
 
     for (const QString& table : tables) {
-        QSqlQuery query(db);
+        QSqlQuery query(connection());
         if (!query.exec("DELETE FROM " + table)) {
             Logger::get().logError("Failed to clear table " + table.toStdString() + ": " +
                                    query.lastError().text().toStdString());
@@ -226,21 +261,21 @@ bool DatabaseManager::clearAllData() {
 
 bool DatabaseManager::beginTransaction() {
     if (!isConnected()) return false;
-    return db.transaction();
+    return connection().transaction();
 }
 
 bool DatabaseManager::commitTransaction() {
     if (!isConnected()) return false;
-    return db.commit();
+    return connection().commit();
 }
 
 bool DatabaseManager::rollbackTransaction() {
     if (!isConnected()) return false;
-    return db.rollback();
+    return connection().rollback();
 }
 
 bool DatabaseManager::executeQuery(const QString& query, const QVariantList& params) {
-    QSqlQuery sqlQuery(db);
+    QSqlQuery sqlQuery(connection());
     sqlQuery.prepare(query);
 
     for (const QVariant& param : params) {
@@ -305,18 +340,22 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath) {
 
     bool isExistingDatabase = QFile::exists(databasePath);
 
-    if (QSqlDatabase::contains("schedulify_connection")) {
-        QSqlDatabase::removeDatabase("schedulify_connection");
+    if (QSqlDatabase::contains(MAIN_CONNECTION)) {
+        QSqlDatabase::removeDatabase(MAIN_CONNECTION);
     }
 
-    db = QSqlDatabase::addDatabase("QSQLITE", "schedulify_connection");
+    db = QSqlDatabase::addDatabase("QSQLITE", MAIN_CONNECTION);
     db.setDatabaseName(databasePath);
+    db.setConnectOptions(BUSY_TIMEOUT_OPTION);
 
     if (!db.open()) {
         Logger::get().logError("Failed to open database: " + db.lastError().text().toStdString());
         return false;
     }
 
+    // WAL lets the connections of other threads read while one of them writes
+    DatabaseUtils::enableWALMode(db);
+
     // Initialize managers
     schemaManager = std::make_unique<DatabaseSchema>(db);
     fileManager = std::make_unique<DatabaseFileManager>(db);
@@ -363,12 +402,13 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath) {
             return false;
         }
 
-        // Insert initial metadata with v1
-        insertMetadata("schema_version", "1", "Enhanced database schema version");  // Changed to "1"
+        // Insert initial metadata with the current version
+        insertMetadata("schema_version", to_string(getCurrentSchemaVersion()), "Enhanced database schema version");
         insertMetadata("created_at", QDateTime::currentDateTime().toString(Qt::ISODate).toStdString(), "Database creation timestamp");
         insertMetadata("schema_type", "enhanced", "Schema includes all enhanced schedule metrics");
 
-        Logger::get().logInfo("Fresh database schema v1 created with enhanced features");
+        Logger::get().logInfo("Database schema v" + to_string(getCurrentSchemaVersion()) +
+                              " created with enhanced features");
     }
 
     // Create indexes
@@ -376,6 +416,12 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath) {
         Logger::get().logWarning("Some indexes failed to create");
     }
 
+    // New generations must not reuse the session of a stored one
+    qint64 highestSession = scheduleManager->getHighestSession();
+    if (highestSession > 0) {
+        ScheduleId::reserveSessionsThrough(static_cast<uint32_t>(highestSession));
+    }
+
     // Test write capability
     QSqlQuery writeTest(db);
     if (!writeTest.exec("CREATE TEMP TABLE write_test (id INTEGER)") ||
@@ -388,6 +434,7 @@ bool DatabaseManager::initializeDatabase(const QString& dbPath) {
 
     updateMetadata("last_access", QDateTime::currentDateTime().toString(Qt::ISODate).toStdString());
     isInitialized = true;
+    setConnected(true);
 
     return true;
 }
@@ -396,6 +443,9 @@ void DatabaseManager::forceCleanup() {
     Logger::get().logInfo("Starting FORCE database cleanup...");
 
     try {
+        setConnected(false);
+        retireThreadConnections();
+
         // Reset all managers immediately - don't wait
         scheduleManager.reset();
         courseManager.reset();
@@ -443,8 +493,8 @@ bool DatabaseManager::hasActiveConnections() {
             return false;
         }
 
-        if (QSqlDatabase::contains("schedulify_connection")) {
-            QSqlDatabase checkDb = QSqlDatabase::database("schedulify_connection");
+        if (QSqlDatabase::contains(MAIN_CONNECTION)) {
+            QSqlDatabase checkDb = QSqlDatabase::database(MAIN_CONNECTION);
             return checkDb.isOpen();
         }
         return false;
@@ -463,4 +513,117 @@ void DatabaseManager::forceCloseActiveQueries() {
     } catch (...) {
         // Ignore any errors during force close
     }
-}
\ No newline at end of file
+}
+
+DatabaseFileManager* DatabaseManager::files() {
+    ThreadConnection* pooled = threadConnection();
+    return pooled ? pooled->fileManager.get() : fileManager.get();
+}
+
+DatabaseCourseManager* DatabaseManager::courses() {
+    ThreadConnection* pooled = threadConnection();
+    return pooled ? pooled->courseManager.get() : courseManager.get();
+}
+
+DatabaseScheduleManager* DatabaseManager::schedules() {
+    ThreadConnection* pooled = threadConnection();
+    return pooled ? pooled->scheduleManager.get() : scheduleManager.get();
+}
+
+QSqlDatabase& DatabaseManager::connection() {
+    ThreadConnection* pooled = threadConnection();
+    return pooled ? pooled->db : db;
+}
+
+DatabaseManager::ThreadConnection* DatabaseManager::threadConnection() {
+    std::unique_ptr<ThreadConnection> stale;
+    {
+        lock_guard<mutex> lock(connectionsMutex);
+        if (!connected || std::this_thread::get_id() == ownerThread) {
+            return nullptr;
+        }
+
+        auto found = threadConnections.find(std::this_thread::get_id());
+        if (found != threadConnections.end()) {
+            if (!found->second->retired && found->second->thread == QThread::currentThread()) {
+                return found->second.get();
+            }
+
+            // Left by a database that was closed since, or by an exited thread with the same id
+            stale = std::move(found->second);
+            threadConnections.erase(found);
+        }
+    }
+
+    if (stale) {
+        closeThreadConnection(std::move(stale));
+    }
+    return openThreadConnection();
+}
+
+DatabaseManager::ThreadConnection* DatabaseManager::openThreadConnection() {
+    lock_guard<mutex> lock(connectionsMutex);
+
+    auto created = std::make_unique<ThreadConnection>();
+    created->name = THREAD_CONNECTION_PREFIX + QString::number(nextConnectionId++);
+    created->thread = QThread::currentThread();
+    created->db = QSqlDatabase::cloneDatabase(MAIN_CONNECTION, created->name);
+    created->db.setConnectOptions(BUSY_TIMEOUT_OPTION);
+
+    if (!created->db.open()) {
+        Logger::get().logWarning("Failed to open thread database connection, using the main one: " +
+                                 created->db.lastError().text().toStdString());
+        QString name = created->name;
+        created.reset();
+        QSqlDatabase::removeDatabase(name);
+        return nullptr;
+    }
+
+    created->fileManager = std::make_unique<DatabaseFileManager>(created->db);
+    created->courseManager = std::make_unique<DatabaseCourseManager>(created->db);
+    created->scheduleManager = std::make_unique<DatabaseScheduleManager>(created->db);
+
+    // Qt connections are closed by the thread that opened them
+    threadConnectionRelease.pooled = true;
+
+    auto& pooled = threadConnections[std::this_thread::get_id()];
+    pooled = std::move(created);
+    Logger::get().logInfo("Opened database connection " + pooled->name.toStdString() + " for worker thread");
+    return pooled.get();
+}
+
+void DatabaseManager::releaseThreadConnection() {
+    std::unique_ptr<ThreadConnection> released;
+    {
+        lock_guard<mutex> lock(connectionsMutex);
+        auto found = threadConnections.find(std::this_thread::get_id());
+        if (found == threadConnections.end()) {
+            return;
+        }
+        released = std::move(found->second);
+        threadConnections.erase(found);
+    }
+
+    closeThreadConnection(std::move(released));
+}
+
+void DatabaseManager::retireThreadConnections() {
+    // Worker threads may still be using their managers, so they close their connections themselves
+    lock_guard<mutex> lock(connectionsMutex);
+    for (auto& entry : threadConnections) {
+        entry.second->retired = true;
+    }
+}
+
+void DatabaseManager::closeThreadConnection(std::unique_ptr<ThreadConnection> threadConnection) {
+    QString name = threadConnection->name;
+
+    // Managers hold prepared queries, so they go before the connection is closed and removed
+    threadConnection->scheduleManager.reset();
+    threadConnection->courseManager.reset();
+    threadConnection->fileManager.reset();
+    threadConnection->db.close();
+    threadConnection.reset();
+
+    QSqlDatabase::removeDatabase(name);
+}
@@ -0,0 +1,246 @@
+#include "db_schedule_blob.h"
+#include "ScheduleSet.h"
+
+#include <unordered_map>
+
+namespace {
+
+    const int TIME_PADDED = 0;
+    const int TIME_UNPADDED = 1;
+    const int TIME_STRING = 2;
+    const int ITEM_COLUMNS = 7;
+
+    void writeVarint(string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool readVarint(const string& in, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            auto byte = static_cast<uint8_t>(in[pos++]);
+            value |= uint64_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    // Minutes of "H:MM" / "HH:MM" times that format back to the same text, otherwise -1
+    int canonicalMinutes(const string& time, int& form) {
+        size_t colon = time.find(':');
+        if (colon == string::npos || colon == 0 || colon > 2 || time.size() != colon + 3) return -1;
+
+        int value = 0;
+        for (size_t i = 0; i < time.size(); i++) {
+            if (i == colon) continue;
+            if (time[i] < '0' || time[i] > '9') return -1;
+            value = value * 10 + (time[i] - '0');
+        }
+
+        int hours = value / 100;
+        int minutes = value % 100;
+        if (hours > 23 || minutes > 59) return -1;
+
+        form = colon == 2 ? TIME_PADDED : TIME_UNPADDED;
+        return hours * 60 + minutes;
+    }
+
+    string formatTime(int minutes, int form) {
+        int hours = minutes / 60;
+        string text = (form == TIME_PADDED && hours < 10 ? "0" : "") + to_string(hours) + ":";
+        if (minutes % 60 < 10) text += "0";
+        return text + to_string(minutes % 60);
+    }
+
+    // Assigns ids to the distinct pooled strings of one schedule
+    class StringTable {
+    public:
+        uint64_t idOf(const string& text) {
+            auto inserted = ids.emplace(&text, strings.size());
+            if (inserted.second) strings.push_back(&text);
+            return inserted.first->second;
+        }
+
+        void write(string& out) const {
+            writeVarint(out, strings.size());
+            for (const string* text : strings) {
+                writeVarint(out, text->size());
+                out += *text;
+            }
+        }
+
+    private:
+        unordered_map<const string*, uint64_t> ids;
+        vector<const string*> strings;
+    };
+
+    uint64_t timeCode(const InternedString& time, StringTable& table) {
+        int form = TIME_PADDED;
+        int minutes = canonicalMinutes(time, form);
+        if (minutes < 0) {
+            return (table.idOf(time) << 2) | TIME_STRING;
+        }
+        return (uint64_t(minutes) << 2) | form;
+    }
+}
+
+string DatabaseScheduleBlob::encode(const InformativeSchedule& schedule) {
+    return encodeWeek(ScheduleSet::weekOf(schedule));
+}
+
+string DatabaseScheduleBlob::encodeWeek(const vector<ScheduleDay>& week) {
+    // Day names are plain strings, so they are pooled here to share the table
+    vector<InternedString> dayNames;
+    dayNames.reserve(week.size());
+    size_t itemCount = 0;
+    for (const auto& day : week) {
+        dayNames.emplace_back(day.day);
+        itemCount += day.day_items.size();
+    }
+
+    StringTable table;
+    vector<uint64_t> dayIds;
+    dayIds.reserve(week.size());
+    for (const auto& name : dayNames) {
+        dayIds.push_back(table.idOf(name));
+    }
+
+    vector<vector<uint64_t>> columns(ITEM_COLUMNS);
+    for (auto& column : columns) {
+        column.reserve(itemCount);
+    }
+    for (const auto& day : week) {
+        for (const auto& item : day.day_items) {
+            columns[0].push_back(table.idOf(item.courseName));
+            columns[1].push_back(table.idOf(item.raw_id));
+            columns[2].push_back(table.idOf(item.type));
+            columns[3].push_back(table.idOf(item.building));
+            columns[4].push_back(table.idOf(item.room));
+            columns[5].push_back(timeCode(item.start, table));
+            columns[6].push_back(timeCode(item.end, table));
+        }
+    }
+
+    string blob;
+    blob.reserve(64 + itemCount * ITEM_COLUMNS * 2);
+    blob.push_back(static_cast<char>(VERSION));
+    table.write(blob);
+
+    writeVarint(blob, week.size());
+    for (size_t i = 0; i < week.size(); i++) {
+        writeVarint(blob, dayIds[i]);
+        writeVarint(blob, week[i].day_items.size());
+    }
+
+    for (const auto& column : columns) {
+        for (uint64_t value : column) {
+            writeVarint(blob, value);
+        }
+    }
+
+    return blob;
+}
+
+bool DatabaseScheduleBlob::decode(const string& blob, InformativeSchedule& schedule) {
+    return decodeWeek(blob, schedule.week);
+}
+
+bool DatabaseScheduleBlob::decodeWeek(const string& blob, vector<ScheduleDay>& result) {
+    result.clear();
+    if (blob.empty() || static_cast<uint8_t>(blob[0]) != VERSION) return false;
+
+    size_t pos = 1;
+    uint64_t count = 0;
+
+    if (!readVarint(blob, pos, count) || count > blob.size()) return false;
+    vector<InternedString> strings;
+    strings.reserve(count);
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t length = 0;
+        if (!readVarint(blob, pos, length) || length > blob.size() - pos) return false;
+        strings.emplace_back(blob.substr(pos, length));
+        pos += length;
+    }
+
+    if (!readVarint(blob, pos, count) || count > blob.size()) return false;
+    vector<ScheduleDay> week(count);
+    for (auto& day : week) {
+        uint64_t nameId = 0;
+        uint64_t items = 0;
+        if (!readVarint(blob, pos, nameId) || nameId >= strings.size()) return false;
+        if (!readVarint(blob, pos, items) || items > blob.size()) return false;
+        day.day = strings[nameId].str();
+        day.day_items.resize(items);
+    }
+
+    // Time codes repeat across items, so each is formatted and pooled once
+    unordered_map<uint64_t, InternedString> times;
+    auto timeOf = [&](uint64_t code, InternedString& time) {
+        if ((code & 3) == TIME_STRING) {
+            if ((code >> 2) >= strings.size()) return false;
+            time = strings[code >> 2];
+            return true;
+        }
+        if ((code & 3) > TIME_UNPADDED || (code >> 2) >= 24 * 60) return false;
+
+        auto cached = times.find(code);
+        if (cached == times.end()) {
+            cached = times.emplace(code, InternedString(formatTime(int(code >> 2), int(code & 3)))).first;
+        }
+        time = cached->second;
+        return true;
+    };
+
+    for (int column = 0; column < ITEM_COLUMNS; column++) {
+        for (auto& day : week) {
+            for (auto& item : day.day_items) {
+                uint64_t value = 0;
+                if (!readVarint(blob, pos, value)) return false;
+
+                bool valid = true;
+                switch (column) {
+                    case 5: valid = timeOf(value, item.start); break;
+                    case 6: valid = timeOf(value, item.end); break;
+                    default: {
+                        if (value >= strings.size()) return false;
+                        InternedString* fields[] = {&item.courseName, &item.raw_id, &item.type,
+                                                    &item.building, &item.room};
+                        *fields[column] = strings[value];
+                    }
+                }
+                if (!valid) return false;
+            }
+        }
+    }
+
+    if (pos != blob.size()) return false;
+
+    result = std::move(week);
+    return true;
+}
+
+string DatabaseScheduleBlob::encodeTuple(const vector<uint32_t>& tuple) {
+    string blob;
+    blob.reserve(tuple.size() * 2);
+    for (uint32_t option : tuple) {
+        writeVarint(blob, option);
+    }
+    return blob;
+}
+
+bool DatabaseScheduleBlob::decodeTuple(const string& blob, vector<uint32_t>& tuple) {
+    tuple.clear();
+    size_t pos = 0;
+    while (pos < blob.size()) {
+        uint64_t option = 0;
+        if (!readVarint(blob, pos, option) || option > UINT32_MAX) {
+            tuple.clear();
+            return false;
+        }
+        tuple.push_back(static_cast<uint32_t>(option));
+    }
+    return true;
+}
@@ -1,21 +1,12 @@
 #include "db_schedules.h"
 #include "sql_validator.h"
+#include "ScheduleId.h"
 
-DatabaseScheduleManager::DatabaseScheduleManager(QSqlDatabase& database) : db(database) {
-}
+namespace {
 
-// insert schedules
-
-bool DatabaseScheduleManager::insertSchedule(const InformativeSchedule& schedule) {
-    if (!db.isOpen()) {
-        Logger::get().logError("Database not open for schedule insertion");
-        return false;
-    }
-
-    QSqlQuery query(db);
-    query.prepare(R"(
+    const QString SCHEDULE_INSERT = R"(
         INSERT INTO schedule
-        (schedule_index, semester, schedule_data_json,
+        (schedule_index, unique_id, unique_key, semester, schedule_data_json, schedule_data, generation_id, option_tuple,
          amount_days, amount_gaps, gaps_time, avg_start, avg_end,
          earliest_start, latest_end, longest_gap, total_class_time,
          consecutive_days, days_json, weekend_classes,
@@ -25,68 +16,89 @@ bool DatabaseScheduleManager::insertSchedule(const InformativeSchedule& schedule
          schedule_span, compactness_ratio, weekday_only,
          has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday,
          created_at, updated_at)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,
-                CURRENT_TIMESTAMP, CURRENT_TIMESTAMP)
-    )");
+    )";
+
+    const QString SCHEDULE_ROW = "(?, ?, ?, ?, '', ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                 "CURRENT_TIMESTAMP, CURRENT_TIMESTAMP)";
+
+    const QString OPTION_INSERT = "INSERT OR IGNORE INTO schedule_option (generation_id, course_position, option_index, week_data)";
+    const QString OPTION_ROW = "(?, ?, ?, ?)";
+
+    // SQLite's default SQLITE_MAX_VARIABLE_NUMBER before 3.32, the lowest limit a build may have
+    const int MAX_STATEMENT_VARIABLES = 999;
+
+    // Bound values of one schedule row, in SCHEDULE_INSERT column order
+    QVariantList scheduleRow(const InformativeSchedule& schedule, const QVariant& scheduleData,
+                             const QVariant& generationId, const QVariant& optionTuple) {
+        QVariantList values;
+        values << schedule.index                                             // 1
+               << QString::fromStdString(schedule.unique_id)                 // 2 - ADDED UNIQUE_ID
+               << static_cast<qint64>(schedule.unique_key)                   // 2b
+               << QString::fromStdString(schedule.semester)                  // 3 - ADDED SEMESTER
+               << scheduleData                                               // 4
+               << generationId                                               // 4b
+               << optionTuple                                                // 4c
+               << schedule.amount_days                                       // 5
+               << schedule.amount_gaps                                       // 6
+               << schedule.gaps_time                                         // 7
+               << schedule.avg_start                                         // 8
+               << schedule.avg_end                                           // 9
+               << schedule.earliest_start                                    // 10
+               << schedule.latest_end                                        // 11
+               << schedule.longest_gap                                       // 12
+               << schedule.total_class_time                                  // 13
+               << schedule.consecutive_days                                  // 14
+               << QString::fromStdString(schedule.days_json)                 // 15
+               << schedule.weekend_classes                                   // 16
+               << schedule.has_morning_classes                               // 17
+               << schedule.has_early_morning                                 // 18
+               << schedule.has_evening_classes                               // 19
+               << schedule.has_late_evening                                  // 20
+               << schedule.max_daily_hours                                   // 21
+               << schedule.min_daily_hours                                   // 22
+               << schedule.avg_daily_hours                                   // 23
+               << schedule.has_lunch_break                                   // 24
+               << schedule.max_daily_gaps                                    // 25
+               << schedule.avg_gap_length                                    // 26
+               << schedule.schedule_span                                     // 27
+               << schedule.compactness_ratio                                 // 28
+               << schedule.weekday_only                                      // 29
+               << schedule.has_monday                                        // 30
+               << schedule.has_tuesday                                       // 31
+               << schedule.has_wednesday                                     // 32
+               << schedule.has_thursday                                      // 33
+               << schedule.has_friday                                        // 34
+               << schedule.has_saturday                                      // 35
+               << schedule.has_sunday;                                       // 36
+        return values;
+    }
+}
 
-    string scheduleJson = DatabaseJsonHelpers::scheduleToJson(schedule);
-
-    // Bind all values in correct order
-    query.addBindValue(schedule.index);                                     // 1
-    query.addBindValue(QString::fromStdString(schedule.unique_id));          // 2 - ADDED UNIQUE_ID
-    query.addBindValue(QString::fromStdString(schedule.semester));          // 3 - ADDED SEMESTER
-    query.addBindValue(QString::fromStdString(scheduleJson));               // 4
-
-    // Basic metrics (5-9)
-    query.addBindValue(schedule.amount_days);                               // 5
-    query.addBindValue(schedule.amount_gaps);                               // 6
-    query.addBindValue(schedule.gaps_time);                                 // 7
-    query.addBindValue(schedule.avg_start);                                 // 8
-    query.addBindValue(schedule.avg_end);                                   // 9
-
-    // Enhanced time metrics (10-13)
-    query.addBindValue(schedule.earliest_start);                            // 10
-    query.addBindValue(schedule.latest_end);                                // 11
-    query.addBindValue(schedule.longest_gap);                               // 12
-    query.addBindValue(schedule.total_class_time);                          // 13
-
-    // Day patterns (14-16)
-    query.addBindValue(schedule.consecutive_days);                          // 14
-    query.addBindValue(QString::fromStdString(schedule.days_json));         // 15
-    query.addBindValue(schedule.weekend_classes);                           // 16
-
-    // Time preference booleans (17-20)
-    query.addBindValue(schedule.has_morning_classes);                       // 17
-    query.addBindValue(schedule.has_early_morning);                         // 18
-    query.addBindValue(schedule.has_evening_classes);                       // 19
-    query.addBindValue(schedule.has_late_evening);                          // 20
-
-    // Daily intensity (21-23)
-    query.addBindValue(schedule.max_daily_hours);                           // 21
-    query.addBindValue(schedule.min_daily_hours);                           // 22
-    query.addBindValue(schedule.avg_daily_hours);                           // 23
-
-    // Gap patterns (24-26)
-    query.addBindValue(schedule.has_lunch_break);                           // 24
-    query.addBindValue(schedule.max_daily_gaps);                            // 25
-    query.addBindValue(schedule.avg_gap_length);                            // 26
-
-    // Compactness (27-29)
-    query.addBindValue(schedule.schedule_span);                             // 27
-    query.addBindValue(schedule.compactness_ratio);                         // 28
-    query.addBindValue(schedule.weekday_only);                              // 29
-
-    // Individual weekdays (30-36)
-    query.addBindValue(schedule.has_monday);                                // 30
-    query.addBindValue(schedule.has_tuesday);                               // 31
-    query.addBindValue(schedule.has_wednesday);                             // 32
-    query.addBindValue(schedule.has_thursday);                              // 33
-    query.addBindValue(schedule.has_friday);                                // 34
-    query.addBindValue(schedule.has_saturday);                              // 35
-    query.addBindValue(schedule.has_sunday);                                // 36
+DatabaseScheduleManager::DatabaseScheduleManager(QSqlDatabase& database) : db(database) {
+}
 
-    if (!query.exec()) {
-        Logger::get().logError("Failed to insert schedule: " + query.lastError().text().toStdString());
+// insert schedules
+
+bool DatabaseScheduleManager::insertSchedule(const InformativeSchedule& schedule) {
+    if (!db.isOpen()) {
+        Logger::get().logError("Database not open for schedule insertion");
+        return false;
+    }
+
+    QSqlQuery* query = cachedStatement(SCHEDULE_INSERT, SCHEDULE_ROW, 1);
+    if (!query) {
+        return false;
+    }
+
+    // The week is stored inline
+    QVariantList values = scheduleRow(schedule, QByteArray::fromStdString(DatabaseScheduleBlob::encode(schedule)),
+                                      QVariant(), QVariant());
+    for (int i = 0; i < values.size(); i++) {
+        query->bindValue(i, values[i]);
+    }
+
+    if (!query->exec()) {
+        Logger::get().logError("Failed to insert schedule: " + query->lastError().text().toStdString());
         return false;
     }
 
@@ -118,72 +130,61 @@ bool DatabaseScheduleManager::insertSchedulesBulk(const vector<InformativeSchedu
     // Optimize database for bulk operations
     DatabaseUtils::optimizeForBulkInserts(db);
 
+    // Generations known before this call; rows stored by it are rolled back together on failure
+    set<qint64> knownGenerations;
+    for (const auto& generation : generations) {
+        knownGenerations.insert(generation.first);
+    }
+
     try {
+        // The generation row, its option weeks and the schedule rows are committed together
+        DatabaseUtils::BatchTransaction transaction(db);
+        if (!transaction.isActive()) {
+            DatabaseUtils::restoreNormalSettings(db);
+            return false;
+        }
+
         // Prepare batch data
         vector<QVariantList> batchData;
         batchData.reserve(schedules.size());
 
-        // FIXED: Added semester and unique_id fields to the INSERT query
-        const QString insertQuery = R"(
-            INSERT INTO schedule
-            (schedule_index, unique_id, semester, schedule_data_json,
-             amount_days, amount_gaps, gaps_time, avg_start, avg_end,
-             earliest_start, latest_end, longest_gap, total_class_time,
-             consecutive_days, days_json, weekend_classes,
-             has_morning_classes, has_early_morning, has_evening_classes, has_late_evening,
-             max_daily_hours, min_daily_hours, avg_daily_hours,
-             has_lunch_break, max_daily_gaps, avg_gap_length,
-             schedule_span, compactness_ratio, weekday_only,
-             has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday,
-             created_at, updated_at)
-            VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?,
-                    CURRENT_TIMESTAMP, CURRENT_TIMESTAMP)
-        )";
+        // Schedules from a ScheduleSet are stored as option tuples of their generation, whose
+        // option weeks are written once; other schedules keep their week inline
+        vector<QVariantList> optionData;
+        bool success = true;
 
         for (const auto& schedule : schedules) {
-            QVariantList values;
-            values << schedule.index                                             // 1
-                   << QString::fromStdString(schedule.unique_id)                 // 2 - ADDED UNIQUE_ID
-                   << QString::fromStdString(schedule.semester)                  // 3 - ADDED SEMESTER
-                   << QString::fromStdString(DatabaseJsonHelpers::scheduleToJson(schedule)) // 4
-                   << schedule.amount_days                                       // 5
-                   << schedule.amount_gaps                                       // 6
-                   << schedule.gaps_time                                         // 7
-                   << schedule.avg_start                                         // 8
-                   << schedule.avg_end                                           // 9
-                   << schedule.earliest_start                                    // 10
-                   << schedule.latest_end                                        // 11
-                   << schedule.longest_gap                                       // 12
-                   << schedule.total_class_time                                  // 13
-                   << schedule.consecutive_days                                  // 14
-                   << QString::fromStdString(schedule.days_json)                 // 15
-                   << schedule.weekend_classes                                   // 16
-                   << schedule.has_morning_classes                               // 17
-                   << schedule.has_early_morning                                 // 18
-                   << schedule.has_evening_classes                               // 19
-                   << schedule.has_late_evening                                  // 20
-                   << schedule.max_daily_hours                                   // 21
-                   << schedule.min_daily_hours                                   // 22
-                   << schedule.avg_daily_hours                                   // 23
-                   << schedule.has_lunch_break                                   // 24
-                   << schedule.max_daily_gaps                                    // 25
-                   << schedule.avg_gap_length                                    // 26
-                   << schedule.schedule_span                                     // 27
-                   << schedule.compactness_ratio                                 // 28
-                   << schedule.weekday_only                                      // 29
-                   << schedule.has_monday                                        // 30
-                   << schedule.has_tuesday                                       // 31
-                   << schedule.has_wednesday                                     // 32
-                   << schedule.has_thursday                                      // 33
-                   << schedule.has_friday                                        // 34
-                   << schedule.has_saturday                                      // 35
-                   << schedule.has_sunday;                                       // 36
-
-            batchData.push_back(values);
+            QVariant scheduleData;
+            QVariant generationId;
+            QVariant optionTuple;
+
+            const StoredGeneration* generation = nullptr;
+            if (!storeGeneration(schedule, optionData, generation)) {
+                success = false;
+                break;
+            }
+            if (generation) {
+                vector<uint32_t> tuple = schedule.source->tupleOf(schedule.source_position);
+                generationId = generation->id;
+                optionTuple = QByteArray::fromStdString(DatabaseScheduleBlob::encodeTuple(tuple));
+            } else {
+                scheduleData = QByteArray::fromStdString(DatabaseScheduleBlob::encode(schedule));
+            }
+
+            batchData.push_back(scheduleRow(schedule, scheduleData, generationId, optionTuple));
         }
 
+        // Option weeks go first so every stored tuple can be resolved
+        success = success && (optionData.empty() || insertRows(OPTION_INSERT, OPTION_ROW, optionData));
+
         // Execute batch insert
-        bool success = DatabaseUtils::executeBatch(db, insertQuery, batchData);
+        success = success && insertRows(SCHEDULE_INSERT, SCHEDULE_ROW, batchData);
+
+        if (success) {
+            success = transaction.commit();
+        } else {
+            transaction.rollback();
+        }
 
         // Restore normal database settings
         DatabaseUtils::restoreNormalSettings(db);
@@ -191,6 +192,7 @@ bool DatabaseScheduleManager::insertSchedulesBulk(const vector<InformativeSchedu
         if (success) {
             Logger::get().logInfo("Bulk insert completed successfully");
         } else {
+            forgetUncommittedGenerations(knownGenerations);
             Logger::get().logError("Bulk insert failed");
         }
 
@@ -198,11 +200,135 @@ bool DatabaseScheduleManager::insertSchedulesBulk(const vector<InformativeSchedu
 
     } catch (const exception& e) {
         Logger::get().logError("Exception during bulk insert: " + string(e.what()));
+        forgetUncommittedGenerations(knownGenerations);
         DatabaseUtils::restoreNormalSettings(db);
         return false;
     }
 }
 
+void DatabaseScheduleManager::forgetUncommittedGenerations(const set<qint64>& knownGenerations) {
+    // Generation rows created by the failed call were rolled back; the option rows of the others are
+    // written again with later chunks
+    for (auto generation = generations.begin(); generation != generations.end();) {
+        if (!knownGenerations.count(generation->first)) {
+            generation = generations.erase(generation);
+        } else {
+            generation->second.storedOptions.clear();
+            ++generation;
+        }
+    }
+}
+
+QSqlQuery* DatabaseScheduleManager::cachedStatement(const QString& insert, const QString& rowValues, int rows) {
+    QString key = insert + "#" + QString::number(rows);
+    auto cached = statements.find(key);
+    if (cached != statements.end()) {
+        return &cached->second;
+    }
+
+    QStringList values;
+    for (int i = 0; i < rows; i++) {
+        values << rowValues;
+    }
+
+    QSqlQuery query(db);
+    if (!query.prepare(insert + " VALUES " + values.join(", "))) {
+        Logger::get().logError("Failed to prepare insert statement: " + query.lastError().text().toStdString());
+        return nullptr;
+    }
+
+    return &statements.emplace(key, query).first->second;
+}
+
+bool DatabaseScheduleManager::insertRows(const QString& insert, const QString& rowValues, const vector<QVariantList>& rows) {
+    if (!multiRowInserts) {
+        return DatabaseUtils::executeBatch(db, insert + " VALUES " + rowValues, rows, false);
+    }
+
+    if (rows.empty()) {
+        return true;
+    }
+
+    // Each statement carries as many rows as its bound variables allow
+    size_t rowsPerStatement = max<size_t>(1, MAX_STATEMENT_VARIABLES / max<size_t>(1, rows.front().size()));
+
+    for (size_t first = 0; first < rows.size(); first += rowsPerStatement) {
+        size_t count = min(rowsPerStatement, rows.size() - first);
+        QSqlQuery* query = cachedStatement(insert, rowValues, static_cast<int>(count));
+        if (!query) {
+            return false;
+        }
+
+        int position = 0;
+        for (size_t row = first; row < first + count; row++) {
+            for (const QVariant& value : rows[row]) {
+                query->bindValue(position++, value);
+            }
+        }
+
+        if (!query->exec()) {
+            Logger::get().logError("Multi-row insert failed: " + query->lastError().text().toStdString());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseScheduleManager::storeGeneration(const InformativeSchedule& schedule, vector<QVariantList>& optionData,
+                                              const StoredGeneration*& generation) {
+    generation = nullptr;
+    // Schedules read back from storage keep their week inline when written again
+    const ScheduleSet* set = schedule.source.get();
+    if (!set || set->fromStorage() || schedule.unique_key == 0 || schedule.source_position >= set->size()) {
+        return true;
+    }
+
+    qint64 sessionKey = static_cast<qint64>(schedule.unique_key >> 32);
+    auto stored = generations.find(sessionKey);
+    if (stored == generations.end()) {
+        QSqlQuery insert(db);
+        insert.prepare("INSERT INTO schedule_generation (session_key, semester, course_count) VALUES (?, ?, ?)");
+        insert.addBindValue(sessionKey);
+        insert.addBindValue(QString::fromStdString(schedule.semester));
+        insert.addBindValue(static_cast<qint64>(set->courseCount()));
+
+        if (!insert.exec()) {
+            // A row this manager did not create belongs to another generation; adopting it would mix
+            // the two generations' option weeks
+            QSqlQuery existing(db);
+            existing.prepare("SELECT 1 FROM schedule_generation WHERE session_key = ?");
+            existing.addBindValue(sessionKey);
+            if (existing.exec() && existing.next()) {
+                Logger::get().logError("Schedule generation session " + to_string(sessionKey) + " is already stored");
+                return false;
+            }
+
+            Logger::get().logWarning("Failed to store schedule generation, storing weeks inline: " +
+                                     insert.lastError().text().toStdString());
+            return true;
+        }
+
+        stored = generations.emplace(sessionKey, StoredGeneration()).first;
+        stored->second.id = insert.lastInsertId().toLongLong();
+    }
+
+    vector<uint32_t> tuple = set->tupleOf(schedule.source_position);
+    for (size_t course = 0; course < tuple.size(); course++) {
+        if (!stored->second.storedOptions.insert((uint64_t(course) << 32) | tuple[course]).second) continue;
+
+        QVariantList values;
+        values << stored->second.id
+               << static_cast<qint64>(course)
+               << static_cast<qint64>(tuple[course])
+               << QByteArray::fromStdString(DatabaseScheduleBlob::encodeWeek(set->optionWeek(course, tuple[course])));
+        optionData.push_back(values);
+    }
+
+    generation = &stored->second;
+    return true;
+}
+
 
 // remove schedules
 
@@ -218,6 +344,14 @@ bool DatabaseScheduleManager::deleteAllSchedules() {
         return false;
     }
 
+    // Generations and their option weeks are only referenced by schedule rows
+    generations.clear();
+    QSqlQuery generationQuery(db);
+    if (!generationQuery.exec("DELETE FROM schedule_option") || !generationQuery.exec("DELETE FROM schedule_generation")) {
+        Logger::get().logError("Failed to delete schedule generations: " + generationQuery.lastError().text().toStdString());
+        return false;
+    }
+
     int rowsAffected = query.numRowsAffected();
     Logger::get().logInfo("Deleted all schedules from database (" + to_string(rowsAffected) + " schedules)");
     return true;
@@ -379,6 +513,19 @@ vector<int> DatabaseScheduleManager::getScheduleIndicesByUniqueIds(const vector<
         return indices;
     }
 
+    // IDs of the current format are looked up by their integer key
+    vector<qint64> keys;
+    keys.reserve(uniqueIds.size());
+    for (const string& uniqueId : uniqueIds) {
+        uint64_t key;
+        if (!ScheduleId::parseKey(uniqueId, key)) {
+            keys.clear();
+            break;
+        }
+        keys.push_back(static_cast<qint64>(key));
+    }
+    const bool byKey = !keys.empty();
+
     // Create IN clause for the query
     QString inClause = "(";
     for (size_t i = 0; i < uniqueIds.size(); ++i) {
@@ -387,7 +534,8 @@ vector<int> DatabaseScheduleManager::getScheduleIndicesByUniqueIds(const vector<
     }
     inClause += ")";
 
-    QString queryStr = QString("SELECT schedule_index FROM schedule WHERE unique_id IN %1 ORDER BY schedule_index").arg(inClause);
+    QString queryStr = QString("SELECT schedule_index FROM schedule WHERE %1 IN %2 ORDER BY schedule_index")
+            .arg(QString(byKey ? "unique_key" : "unique_id"), inClause);
 
     QSqlQuery query(db);
     if (!query.prepare(queryStr)) {
@@ -396,8 +544,14 @@ vector<int> DatabaseScheduleManager::getScheduleIndicesByUniqueIds(const vector<
     }
 
     // Bind unique IDs
-    for (const string& uniqueId : uniqueIds) {
-        query.addBindValue(QString::fromStdString(uniqueId));
+    if (byKey) {
+        for (qint64 key : keys) {
+            query.addBindValue(key);
+        }
+    } else {
+        for (const string& uniqueId : uniqueIds) {
+            query.addBindValue(QString::fromStdString(uniqueId));
+        }
     }
 
     if (!query.exec()) {
@@ -432,7 +586,8 @@ vector<InformativeSchedule> DatabaseScheduleManager::getAllSchedules() {
                max_daily_hours, min_daily_hours, avg_daily_hours,
                has_lunch_break, max_daily_gaps, avg_gap_length,
                schedule_span, compactness_ratio, weekday_only,
-               has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday
+               has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday,
+               schedule_data, generation_id, option_tuple
         FROM schedule
         ORDER BY schedule_index
     )");
@@ -442,8 +597,9 @@ vector<InformativeSchedule> DatabaseScheduleManager::getAllSchedules() {
         return schedules;
     }
 
+    StoredSets storedSets;
     while (query.next()) {
-        schedules.push_back(createScheduleFromQuery(query));
+        schedules.push_back(createScheduleFromQuery(query, storedSets));
     }
 
     Logger::get().logInfo("Retrieved " + to_string(schedules.size()) + " schedules from database");
@@ -464,6 +620,23 @@ int DatabaseScheduleManager::getScheduleCount() {
     return -1;
 }
 
+qint64 DatabaseScheduleManager::getHighestSession() {
+    if (!db.isOpen()) {
+        return -1;
+    }
+
+    // unique_key holds the unsigned key in a signed column, so the session is masked back out
+    QSqlQuery query(db);
+    if (query.exec("SELECT MAX(COALESCE((SELECT MAX(session_key) FROM schedule_generation), 0), "
+                   "COALESCE((SELECT MAX((unique_key >> 32) & 4294967295) FROM schedule), 0))") &&
+        query.next()) {
+        return query.value(0).toLongLong();
+    }
+
+    Logger::get().logError("Failed to read the highest schedule session: " + query.lastError().text().toStdString());
+    return -1;
+}
+
 vector<InformativeSchedule> DatabaseScheduleManager::getSchedulesByIds(const vector<int>& scheduleIds) {
     vector<InformativeSchedule> schedules;
 
@@ -495,7 +668,8 @@ vector<InformativeSchedule> DatabaseScheduleManager::getSchedulesByIds(const vec
                    max_daily_hours, min_daily_hours, avg_daily_hours,
                    has_lunch_break, max_daily_gaps, avg_gap_length,
                    schedule_span, compactness_ratio, weekday_only,
-                   has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday
+                   has_monday, has_tuesday, has_wednesday, has_thursday, has_friday, has_saturday, has_sunday,
+                   schedule_data, generation_id, option_tuple
             FROM schedule
             WHERE schedule_index IN %1
             ORDER BY schedule_index
@@ -517,8 +691,9 @@ vector<InformativeSchedule> DatabaseScheduleManager::getSchedulesByIds(const vec
             return schedules;
         }
 
+        StoredSets storedSets;
         while (query.next()) {
-            schedules.push_back(createScheduleFromQuery(query));
+            schedules.push_back(createScheduleFromQuery(query, storedSets));
         }
 
         Logger::get().logInfo("Retrieved " + to_string(schedules.size()) + " schedules by IDs");
@@ -597,7 +772,7 @@ string DatabaseScheduleManager::getSchedulesMetadataForBot() {
     return metadata;
 }
 
-InformativeSchedule DatabaseScheduleManager::createScheduleFromQuery(QSqlQuery& query) {
+InformativeSchedule DatabaseScheduleManager::createScheduleFromQuery(QSqlQuery& query, StoredSets& storedSets) {
     int scheduleIndex = query.value(1).toInt();
     string scheduleJson = query.value(2).toString().toStdString();
 
@@ -637,11 +812,32 @@ InformativeSchedule DatabaseScheduleManager::createScheduleFromQuery(QSqlQuery&
     bool hasSaturday = query.value(33).toBool();
     bool hasSunday = query.value(34).toBool();
 
-    // Create schedule from JSON with basic metrics
+    // The week is an option tuple of a generation, an inline blob, or (for rows written before
+    // schema version 3) JSON
+    string scheduleData = query.value(35).toByteArray().toStdString();
+    bool normalized = !query.value(36).isNull();
     InformativeSchedule schedule = DatabaseJsonHelpers::scheduleFromJson(
-            scheduleJson, 0, scheduleIndex, amountDays, amountGaps, gapsTime, avgStart, avgEnd
+            scheduleData.empty() && !normalized ? scheduleJson : string(), 0, scheduleIndex,
+            amountDays, amountGaps, gapsTime, avgStart, avgEnd
     );
 
+    bool decoded = true;
+    if (normalized) {
+        // The week is joined from the generation's option weeks only when it is asked for
+        vector<uint32_t> tuple;
+        const shared_ptr<ScheduleSet>& set = loadGeneration(query.value(36).toLongLong(), storedSets);
+        decoded = set && DatabaseScheduleBlob::decodeTuple(query.value(37).toByteArray().toStdString(), tuple) &&
+                  set->appendStored(tuple, schedule.source_position);
+        if (decoded) {
+            schedule.source = set;
+        }
+    } else if (!scheduleData.empty()) {
+        decoded = DatabaseScheduleBlob::decode(scheduleData, schedule);
+    }
+    if (!decoded) {
+        Logger::get().logWarning("Failed to decode schedule data for schedule " + to_string(scheduleIndex));
+    }
+
     // Set enhanced metrics
     schedule.earliest_start = earliestStart;
     schedule.latest_end = latestEnd;
@@ -674,6 +870,43 @@ InformativeSchedule DatabaseScheduleManager::createScheduleFromQuery(QSqlQuery&
     return schedule;
 }
 
+const shared_ptr<ScheduleSet>& DatabaseScheduleManager::loadGeneration(qint64 generationId, StoredSets& storedSets) {
+    auto cached = storedSets.find(generationId);
+    if (cached != storedSets.end()) {
+        return cached->second;
+    }
+
+    // Each option week is decoded once and shared by every schedule of the generation
+    auto& set = storedSets[generationId];
+
+    QSqlQuery query(db);
+    query.prepare("SELECT course_count FROM schedule_generation WHERE id = ?");
+    query.addBindValue(generationId);
+    if (!query.exec() || !query.next()) {
+        Logger::get().logError("Failed to load schedule generation: " + query.lastError().text().toStdString());
+        return set;
+    }
+    size_t courseCount = query.value(0).toULongLong();
+
+    map<uint64_t, vector<ScheduleDay>> weeks;
+    query.prepare("SELECT course_position, option_index, week_data FROM schedule_option WHERE generation_id = ?");
+    query.addBindValue(generationId);
+    if (!query.exec()) {
+        Logger::get().logError("Failed to load schedule options: " + query.lastError().text().toStdString());
+        return set;
+    }
+
+    while (query.next()) {
+        uint64_t key = (query.value(0).toULongLong() << 32) | query.value(1).toUInt();
+        if (!DatabaseScheduleBlob::decodeWeek(query.value(2).toByteArray().toStdString(), weeks[key])) {
+            weeks.erase(key);
+        }
+    }
+
+    set = make_shared<ScheduleSet>(courseCount, std::move(weeks));
+    return set;
+}
+
 
 // helper methods
 
@@ -9,7 +9,8 @@ bool DatabaseSchema::createTables() {
     return createMetadataTable() &&
            createFileTable() &&
            createCourseTable() &&
-           createScheduleTable();
+           createScheduleTable() &&
+           createScheduleGenerationTables();
 }
 
 bool DatabaseSchema::createIndexes() {
@@ -217,8 +218,12 @@ bool DatabaseSchema::createScheduleTable() {
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             schedule_index INTEGER NOT NULL,
             unique_id TEXT NOT NULL UNIQUE,
+            unique_key INTEGER NOT NULL DEFAULT 0,
             semester TEXT NOT NULL DEFAULT 'A',
             schedule_data_json TEXT NOT NULL,
+            schedule_data BLOB,
+            generation_id INTEGER,
+            option_tuple BLOB,
             amount_days INTEGER NOT NULL,
             amount_gaps INTEGER NOT NULL,
             gaps_time INTEGER NOT NULL,
@@ -261,6 +266,61 @@ bool DatabaseSchema::createScheduleTable() {
         return false;
     }
 
+    // Tables from schema version 1 predate the integer key, those before version 3 the binary
+    // week (their schedule_data_json rows stay readable) and those before version 4 the tuples
+    const std::vector<std::pair<QString, QString>> addedColumns = {
+            {"unique_key", "INTEGER NOT NULL DEFAULT 0"},
+            {"schedule_data", "BLOB"},
+            {"generation_id", "INTEGER"},
+            {"option_tuple", "BLOB"},
+    };
+
+    QSqlQuery columns("PRAGMA table_info(schedule)", db);
+    QStringList existingColumns;
+    while (columns.next()) {
+        existingColumns << columns.value(1).toString();
+    }
+
+    for (const auto& column : addedColumns) {
+        if (!existingColumns.contains(column.first) &&
+            !executeQuery("ALTER TABLE schedule ADD COLUMN " + column.first + " " + column.second)) {
+            Logger::get().logError("Failed to add " + column.first.toStdString() + " to schedule table");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DatabaseSchema::createScheduleGenerationTables() {
+    // One row per generation; schedules of a generation share the weeks of its options
+    const QString generationQuery = R"(
+        CREATE TABLE IF NOT EXISTS schedule_generation (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            session_key INTEGER NOT NULL UNIQUE,
+            semester TEXT NOT NULL DEFAULT 'A',
+            course_count INTEGER NOT NULL,
+            created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+        )
+    )";
+
+    // Week items of one course option, stored once and referenced by schedule.option_tuple
+    const QString optionQuery = R"(
+        CREATE TABLE IF NOT EXISTS schedule_option (
+            generation_id INTEGER NOT NULL,
+            course_position INTEGER NOT NULL,
+            option_index INTEGER NOT NULL,
+            week_data BLOB NOT NULL,
+            PRIMARY KEY (generation_id, course_position, option_index),
+            FOREIGN KEY (generation_id) REFERENCES schedule_generation(id) ON DELETE CASCADE
+        )
+    )";
+
+    if (!executeQuery(generationQuery) || !executeQuery(optionQuery)) {
+        Logger::get().logError("Failed to create schedule generation tables");
+        return false;
+    }
+
     return true;
 }
 
@@ -302,6 +362,16 @@ bool DatabaseSchema::createScheduleIndexes() {
         success = false;
     }
 
+    if (!executeQuery("CREATE INDEX IF NOT EXISTS idx_schedule_unique_key ON schedule(unique_key)")) {
+        Logger::get().logWarning("Failed to create schedule unique_key index");
+        success = false;
+    }
+
+    if (!executeQuery("CREATE INDEX IF NOT EXISTS idx_schedule_generation ON schedule(generation_id)")) {
+        Logger::get().logWarning("Failed to create schedule generation_id index");
+        success = false;
+    }
+
     if (!executeQuery("CREATE INDEX IF NOT EXISTS idx_schedule_index ON schedule(schedule_index)")) {
         Logger::get().logWarning("Failed to create schedule index index");
         success = false;
@@ -4,8 +4,10 @@
 #include <QFileInfo>
 #include <QTime>
 #include <QElapsedTimer>
+#include <memory>
 
 DatabaseUtils::PerformanceStats DatabaseUtils::performanceStats;
+std::mutex DatabaseUtils::statsMutex;
 
 bool DatabaseUtils::enableWALMode(QSqlDatabase& db) {
     if (!db.isOpen()) {
@@ -33,12 +35,12 @@ bool DatabaseUtils::optimizeForBulkInserts(QSqlDatabase& db) {
     QSqlQuery query(db);
     bool success = true;
 
-    // Optimize settings for bulk inserts
+    // Optimize settings for bulk inserts; the journal stays in WAL mode, since leaving it needs
+    // exclusive access and would block readers on other connections
     std::vector<QString> optimizations = {
             "PRAGMA synchronous=OFF",           // Faster writes, less crash safety
             "PRAGMA cache_size=10000",          // Larger cache
-            "PRAGMA temp_store=MEMORY",         // Use memory for temp storage
-            "PRAGMA journal_mode=MEMORY"        // Keep journal in memory
+            "PRAGMA temp_store=MEMORY"          // Use memory for temp storage
     };
 
     for (const QString& pragma : optimizations) {
@@ -87,7 +89,7 @@ bool DatabaseUtils::restoreNormalSettings(QSqlDatabase& db) {
 }
 
 bool DatabaseUtils::executeBatch(QSqlDatabase& db, const QString& query,
-                                 const std::vector<QVariantList>& batchData) {
+                                 const std::vector<QVariantList>& batchData, bool ownTransaction) {
     if (!db.isOpen() || batchData.empty()) {
         return false;
     }
@@ -95,10 +97,13 @@ bool DatabaseUtils::executeBatch(QSqlDatabase& db, const QString& query,
     QElapsedTimer timer;
     timer.start();
 
-    BatchTransaction transaction(db);
-    if (!transaction.isActive()) {
-        recordQuery(false, timer.elapsed(), "Failed to start batch transaction");
-        return false;
+    std::unique_ptr<BatchTransaction> transaction;
+    if (ownTransaction) {
+        transaction = std::make_unique<BatchTransaction>(db);
+        if (!transaction->isActive()) {
+            recordQuery(false, timer.elapsed(), "Failed to start batch transaction");
+            return false;
+        }
     }
 
     QSqlQuery sqlQuery(db);
@@ -126,7 +131,7 @@ bool DatabaseUtils::executeBatch(QSqlDatabase& db, const QString& query,
 
     bool success = (successCount == static_cast<int>(batchData.size()));
 
-    if (success && transaction.commit()) {
+    if (success && (!transaction || transaction->commit())) {
         recordQuery(true, timer.elapsed());
         Logger::get().logInfo("Batch execution successful: " + std::to_string(successCount) + " queries");
         return true;
@@ -276,15 +281,18 @@ void DatabaseUtils::BatchTransaction::rollback() {
 }
 
 // Performance monitoring
-DatabaseUtils::PerformanceStats& DatabaseUtils::getStats() {
+DatabaseUtils::PerformanceStats DatabaseUtils::getStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
     return performanceStats;
 }
 
 void DatabaseUtils::resetStats() {
+    std::lock_guard<std::mutex> lock(statsMutex);
     performanceStats = PerformanceStats();
 }
 
 void DatabaseUtils::logPerformanceReport() {
+    std::lock_guard<std::mutex> lock(statsMutex);
     Logger::get().logInfo("=== DATABASE PERFORMANCE REPORT ===");
     Logger::get().logInfo("Total Queries: " + std::to_string(performanceStats.totalQueries));
     Logger::get().logInfo("Successful: " + std::to_string(performanceStats.successfulQueries));
@@ -297,6 +305,7 @@ void DatabaseUtils::logPerformanceReport() {
 }
 
 void DatabaseUtils::recordQuery(bool success, double timeMs, const std::string& error) {
+    std::lock_guard<std::mutex> lock(statsMutex);
     performanceStats.totalQueries++;
 
     if (success) {
@@ -1,4 +1,5 @@
 #include "excel_parser.h"
+#include "TimeUtils.h"
 
 // Constructor implementation
 ExcelCourseParser::ExcelCourseParser() {
@@ -215,6 +216,9 @@ Session ExcelCourseParser::parseSingleSession(const string& timeSlotStr, const s
     if (regex_search(timePart, timeMatch, timePattern)) {
         session.start_time = timeMatch[1].str();
         session.end_time = timeMatch[2].str();
+
+        // Cache integer minutes so the scheduling hot path never re-parses the strings
+        TimeUtils::compileSession(session);
     }
 
     // Parse room format: supports both "הנדסה-1104 - 243" and "וואהל 1401 - 4"
@@ -1,4 +1,5 @@
 #include "parseCoursesToVector.h"
+#include "TimeUtils.h"
 
 using namespace std;
 
@@ -244,6 +245,9 @@ Session parseSingleSession(const string& line) {
             throw invalid_argument(message.str());
         }
 
+        // Cache integer minutes so the scheduling hot path never re-parses the strings
+        TimeUtils::compileSession(s);
+
         getline(ss, token, ',');
         if (validateLocation(token,4)) {
             s.building_number = token;
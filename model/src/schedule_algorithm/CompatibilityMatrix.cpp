@@ -0,0 +1,76 @@
+#include "CompatibilityMatrix.h"
+
+void CompatibilityMatrix::build(const vector<vector<CourseSelection>>& allOptions) {
+    courseCount = allOptions.size();
+    optionCounts.assign(courseCount, 0);
+    wordCounts.assign(courseCount, 0);
+    pairOffsets.assign(courseCount * courseCount, 0);
+    cells.clear();
+
+    for (size_t i = 0; i < courseCount; i++) {
+        optionCounts[i] = allOptions[i].size();
+        wordCounts[i] = (optionCounts[i] + 63) / 64;
+    }
+
+    size_t totalWords = 0;
+    for (size_t i = 0; i < courseCount; i++) {
+        for (size_t j = 0; j < courseCount; j++) {
+            pairOffsets[i * courseCount + j] = totalWords;
+            if (i != j) {
+                totalWords += optionCounts[i] * wordCounts[j];
+            }
+        }
+    }
+    cells.assign(totalWords, 0);
+
+    // Each unordered pair is tested once and written in both directions
+    for (size_t i = 0; i < courseCount; i++) {
+        for (size_t j = i + 1; j < courseCount; j++) {
+            uint64_t* forward = &cells[pairOffsets[i * courseCount + j]];
+            uint64_t* backward = &cells[pairOffsets[j * courseCount + i]];
+
+            for (size_t a = 0; a < optionCounts[i]; a++) {
+                for (size_t b = 0; b < optionCounts[j]; b++) {
+                    if (!hasConflict(allOptions[i][a], allOptions[j][b])) {
+                        forward[a * wordCounts[j] + b / 64] |= (uint64_t(1) << (b % 64));
+                        backward[b * wordCounts[i] + a / 64] |= (uint64_t(1) << (a % 64));
+                    }
+                }
+            }
+        }
+    }
+}
+
+OptionBitset CompatibilityMatrix::allOptionsOf(size_t course) const {
+    OptionBitset bits(wordCounts[course], ~uint64_t(0));
+    size_t tailBits = optionCounts[course] % 64;
+    if (tailBits != 0) {
+        bits.back() = (uint64_t(1) << tailBits) - 1;
+    }
+    return bits;
+}
+
+bool CompatibilityMatrix::hasConflict(const CourseSelection& a, const CourseSelection& b) {
+    if (a.occupancy.exact && b.occupancy.exact) {
+        return a.occupancy.intersects(b.occupancy);
+    }
+
+    // Compare each session in a with each session in b
+    for (const SessionTime& s1 : a.sessionTimes) {
+        for (const SessionTime& s2 : b.sessionTimes) {
+            if (s1.day == s2.day && s1.start < s2.end && s2.start < s1.end) return true;
+        }
+    }
+    return false;
+}
+
+size_t CompatibilityMatrix::countOptions(const OptionBitset& bits) {
+    size_t count = 0;
+    for (uint64_t word : bits) {
+        while (word) {
+            word &= word - 1;
+            count++;
+        }
+    }
+    return count;
+}
\ No newline at end of file
@@ -6,94 +6,11 @@ vector<CourseSelection> CourseLegalComb::generate(const Course& course) {
 
     try {
         // Collect all non-empty group types
-        vector<pair<string, vector<const Group*>>> availableGroupTypes;
-
-        if (!course.blocks.empty()) {
-            vector<const Group*> blockGroups;
-            for (const auto& group : course.blocks) {
-                blockGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"blocks", blockGroups});
-        }
-
-        if (!course.Lectures.empty()) {
-            vector<const Group*> lectureGroups;
-            for (const auto& group : course.Lectures) {
-                lectureGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"lectures", lectureGroups});
-        }
-
-        if (!course.Tirgulim.empty()) {
-            vector<const Group*> tutorialGroups;
-            for (const auto& group : course.Tirgulim) {
-                tutorialGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"tutorials", tutorialGroups});
-        }
-
-        if (!course.labs.empty()) {
-            vector<const Group*> labGroups;
-            for (const auto& group : course.labs) {
-                labGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"labs", labGroups});
-        }
-
-        if (!course.DepartmentalSessions.empty()) {
-            vector<const Group*> deptGroups;
-            for (const auto& group : course.DepartmentalSessions) {
-                deptGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"departmental", deptGroups});
-        }
-
-        if (!course.Reinforcements.empty()) {
-            vector<const Group*> reinforcementGroups;
-            for (const auto& group : course.Reinforcements) {
-                reinforcementGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"reinforcements", reinforcementGroups});
-        }
-
-        if (!course.Guidance.empty()) {
-            vector<const Group*> guidanceGroups;
-            for (const auto& group : course.Guidance) {
-                guidanceGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"guidance", guidanceGroups});
-        }
-
-        if (!course.OptionalColloquium.empty()) {
-            vector<const Group*> colloquiumGroups;
-            for (const auto& group : course.OptionalColloquium) {
-                colloquiumGroups.push_back(&group);
+        vector<const GroupTypeSlot*> availableGroupTypes;
+        for (const auto& slot : GROUP_TYPE_SLOTS) {
+            if (!(course.*slot.groups).empty()) {
+                availableGroupTypes.push_back(&slot);
             }
-            availableGroupTypes.push_back({"colloquium", colloquiumGroups});
-        }
-
-        if (!course.Registration.empty()) {
-            vector<const Group*> registrationGroups;
-            for (const auto& group : course.Registration) {
-                registrationGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"registration", registrationGroups});
-        }
-
-        if (!course.Thesis.empty()) {
-            vector<const Group*> thesisGroups;
-            for (const auto& group : course.Thesis) {
-                thesisGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"thesis", thesisGroups});
-        }
-
-        if (!course.Project.empty()) {
-            vector<const Group*> projectGroups;
-            for (const auto& group : course.Project) {
-                projectGroups.push_back(&group);
-            }
-            availableGroupTypes.push_back({"project", projectGroups});
         }
 
         // If no groups are available, return empty combinations
@@ -102,9 +19,21 @@ vector<CourseSelection> CourseLegalComb::generate(const Course& course) {
             return combinations;
         }
 
+        // Occupancy of every group, so partial combinations are checked with a few word ANDs
+        vector<vector<WeekMask>> groupMasks;
+        for (const GroupTypeSlot* slot : availableGroupTypes) {
+            const vector<Group>& groups = course.*slot->groups;
+            vector<WeekMask> masks(groups.size());
+            for (size_t i = 0; i < groups.size(); i++) {
+                masks[i].addGroup(&groups[i]);
+            }
+            groupMasks.push_back(std::move(masks));
+        }
+
         // Generate all combinations using recursive approach
         vector<const Group*> currentCombination;
-        generateCombinationsRecursive(availableGroupTypes, 0, currentCombination, combinations, course.id);
+        generateCombinationsRecursive(course, availableGroupTypes, groupMasks, 0, currentCombination, WeekMask(),
+                                      combinations);
 
         if (combinations.empty()) {
             Logger::get().logWarning("No valid combinations generated for course ID " + to_string(course.id));
@@ -118,40 +47,56 @@ vector<CourseSelection> CourseLegalComb::generate(const Course& course) {
     return combinations;
 }
 
-// Recursive helper method to generate all combinations
+// Recursive helper method to generate all combinations, dropping a partial combination as soon as
+// its last group conflicts with the ones chosen before it
 void CourseLegalComb::generateCombinationsRecursive(
-        const vector<pair<string, vector<const Group*>>>& availableGroupTypes,
+        const Course& course,
+        const vector<const GroupTypeSlot*>& availableGroupTypes,
+        const vector<vector<WeekMask>>& groupMasks,
         int currentTypeIndex,
         vector<const Group*>& currentCombination,
-        vector<CourseSelection>& combinations,
-        int courseId) {
+        const WeekMask& occupied,
+        vector<CourseSelection>& combinations) {
 
     if (currentTypeIndex == availableGroupTypes.size()) {
-        // We have selected one group from each type, check for conflicts
-        if (!hasAnyCombinationConflict(currentCombination)) {
-            // Create CourseSelection from current combination
-            CourseSelection selection = createCourseSelection(currentCombination, availableGroupTypes, courseId);
-            combinations.push_back(selection);
-        }
+        // We have selected one group from each type without conflicts
+        CourseSelection selection = createCourseSelection(currentCombination, availableGroupTypes, course.id);
+        selection.occupancy = occupied;
+        combinations.push_back(selection);
         return;
     }
 
     // Try each group in the current type
-    const auto& currentType = availableGroupTypes[currentTypeIndex];
-    for (const Group* group : currentType.second) {
+    const vector<Group>& currentType = course.*availableGroupTypes[currentTypeIndex]->groups;
+    for (size_t i = 0; i < currentType.size(); i++) {
+        const Group* group = &currentType[i];
+        const WeekMask& mask = groupMasks[currentTypeIndex][i];
+
+        if (hasConflictWithChosen(group, mask, currentCombination, occupied)) {
+            continue;
+        }
+
+        WeekMask next = occupied;
+        next.merge(mask);
+
         currentCombination.push_back(group);
-        generateCombinationsRecursive(availableGroupTypes, currentTypeIndex + 1, currentCombination, combinations, courseId);
+        generateCombinationsRecursive(course, availableGroupTypes, groupMasks, currentTypeIndex + 1,
+                                      currentCombination, next, combinations);
         currentCombination.pop_back();
     }
 }
 
-// Helper method to check if any groups in the combination have conflicts
-bool CourseLegalComb::hasAnyCombinationConflict(const vector<const Group*>& groups) {
-    for (size_t i = 0; i < groups.size(); i++) {
-        for (size_t j = i + 1; j < groups.size(); j++) {
-            if (hasGroupConflict(groups[i], groups[j])) {
-                return true;
-            }
+// Helper method to check a group against the groups already in the combination
+bool CourseLegalComb::hasConflictWithChosen(const Group* group, const WeekMask& mask,
+                                            const vector<const Group*>& chosen, const WeekMask& occupied) {
+    if (mask.exact && occupied.exact) {
+        return mask.intersects(occupied);
+    }
+
+    // Sessions off the slot grid need the exact time comparison
+    for (const Group* other : chosen) {
+        if (hasGroupConflict(group, other)) {
+            return true;
         }
     }
     return false;
@@ -160,50 +105,31 @@ bool CourseLegalComb::hasAnyCombinationConflict(const vector<const Group*>& grou
 // Helper method to create CourseSelection from the selected groups
 CourseSelection CourseLegalComb::createCourseSelection(
         const vector<const Group*>& selectedGroups,
-        const vector<pair<string, vector<const Group*>>>& availableGroupTypes,
+        const vector<const GroupTypeSlot*>& availableGroupTypes,
         int courseId) {
 
-    CourseSelection selection;
+    // Value-initialized: every group slot starts as nullptr
+    CourseSelection selection{};
     selection.courseId = courseId;
-    selection.lectureGroup = nullptr;
-    selection.tutorialGroup = nullptr;
-    selection.labGroup = nullptr;
-    selection.blockGroup = nullptr;
-    selection.departmentalGroup = nullptr;
-    selection.reinforcementGroup = nullptr;
-    selection.guidanceGroup = nullptr;
-    selection.colloquiumGroup = nullptr;
-    selection.registrationGroup = nullptr;
-    selection.thesisGroup = nullptr;
-    selection.projectGroup = nullptr;
-
-    // Map selected groups to their types
+
+    // Each selected group goes straight to the slot of its type
     for (size_t i = 0; i < selectedGroups.size(); i++) {
-        const string& typeName = availableGroupTypes[i].first;
-        const Group* group = selectedGroups[i];
-
-        if (typeName == "lectures") {
-            selection.lectureGroup = group;
-        } else if (typeName == "tutorials") {
-            selection.tutorialGroup = group;
-        } else if (typeName == "labs") {
-            selection.labGroup = group;
-        } else if (typeName == "blocks") {
-            selection.blockGroup = group;
-        } else if (typeName == "departmental") {
-            selection.departmentalGroup = group;
-        } else if (typeName == "reinforcements") {
-            selection.reinforcementGroup = group;
-        } else if (typeName == "guidance") {
-            selection.guidanceGroup = group;
-        } else if (typeName == "colloquium") {
-            selection.colloquiumGroup = group;
-        } else if (typeName == "registration") {
-            selection.registrationGroup = group;
-        } else if (typeName == "thesis") {
-            selection.thesisGroup = group;
-        } else if (typeName == "project") {
-            selection.projectGroup = group;
+        selection.groups[availableGroupTypes[i]->slot] = selectedGroups[i];
+    }
+
+    // Flat session times, so conflict checks never walk the groups or parse strings again.
+    // Sessions whose times do not parse never overlap anything and are left out.
+    for (const auto& slot : GROUP_TYPE_SLOTS) {
+        const Group* group = selection.groups[slot.slot];
+        if (!group) continue;
+
+        for (const auto& session : group->sessions) {
+            try {
+                selection.sessionTimes.push_back({session.day_of_week, TimeUtils::startMinutes(session),
+                                                  TimeUtils::endMinutes(session)});
+            } catch (const exception&) {
+                continue;
+            }
         }
     }
 
@@ -2,25 +2,296 @@
 
 using namespace std;
 
-unordered_map<int, CourseInfo> ScheduleBuilder::courseInfoMap;
-mutex ScheduleBuilder::courseInfoMapMutex;
-string ScheduleBuilder::currentSemester;
-
 // Generate schedule
 
 vector<InformativeSchedule> ScheduleBuilder::build(const vector<Course>& courses, const string& semester) {
+    vector<InformativeSchedule> results;
+
+    try {
+        buildStreaming(courses, semester, [&results](vector<InformativeSchedule>& chunk) {
+            results.insert(results.end(), make_move_iterator(chunk.begin()), make_move_iterator(chunk.end()));
+            return true;
+        });
+    } catch (const std::bad_alloc& e) {
+        Logger::get().logError("Out of memory during schedule generation: " + string(e.what()));
+        results.clear();  // Clear partial results to free memory
+    }
+
+    return results;
+}
+
+size_t ScheduleBuilder::buildStreaming(const vector<Course>& courses, const string& semester,
+                                       const ScheduleChunkCallback& onChunk, size_t chunkSize) {
+    vector<vector<CourseSelection>> allOptions;
+    return generate(courses, semester, allOptions,
+                    [&onChunk](vector<InformativeSchedule>& chunk, vector<vector<int>>&) { return onChunk(chunk); },
+                    chunkSize, false);
+}
+
+vector<InformativeSchedule> ScheduleBuilder::buildCompact(const vector<Course>& courses, const string& semester,
+                                                          const function<bool(const vector<InformativeSchedule>&)>& onChunk) {
+    vector<InformativeSchedule> results;
+
+    try {
+        auto set = make_shared<ScheduleSet>(courses);
+
+        // Options are generated from the set's own copy of the courses so they stay valid with it
+        generate(set->courses, semester, set->options, compactSink(set, results, onChunk), DEFAULT_CHUNK_SIZE, true);
+        // Schedules left out by the constraints may become valid once the courses change
+        set->complete = !stopRequested && !constraints.active();
+        lastSet = set;
+    } catch (const std::bad_alloc& e) {
+        Logger::get().logError("Out of memory during schedule generation: " + string(e.what()));
+        results.clear();
+    }
+
+    return results;
+}
+
+ScheduleBuilder::TupleChunkCallback ScheduleBuilder::compactSink(
+        const shared_ptr<ScheduleSet>& set, vector<InformativeSchedule>& results,
+        const function<bool(const vector<InformativeSchedule>&)>& onChunk) {
+    shared_ptr<const ScheduleSet> source = set;
+
+    return [set, source, &results, &onChunk](vector<InformativeSchedule>& chunk, vector<vector<int>>& tuples) {
+        // Weeks were not built; the observer expands them through the set if it needs them
+        for (size_t i = 0; i < chunk.size(); i++) {
+            chunk[i].source = source;
+            chunk[i].source_position = set->append(tuples[i]);
+        }
+
+        bool keepGoing = !onChunk || onChunk(chunk);
+
+        results.insert(results.end(), make_move_iterator(chunk.begin()), make_move_iterator(chunk.end()));
+        return keepGoing;
+    };
+}
+
+// Incremental generation
+
+namespace {
+
+bool sameSession(const Session& a, const Session& b) {
+    return a.day_of_week == b.day_of_week && a.start_time == b.start_time && a.end_time == b.end_time &&
+           a.building_number == b.building_number && a.room_number == b.room_number;
+}
+
+bool sameSessions(const vector<Session>& a, const vector<Session>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!sameSession(a[i], b[i])) return false;
+    }
+    return true;
+}
+
+bool sameGroups(const vector<Group>& a, const vector<Group>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].type != b[i].type || !sameSessions(a[i].sessions, b[i].sessions)) return false;
+    }
+    return true;
+}
+
+// Same content as far as the generated schedules are concerned
+bool sameCourse(const Course& a, const Course& b) {
+    return a.raw_id == b.raw_id && a.name == b.name &&
+           sameGroups(a.Lectures, b.Lectures) && sameGroups(a.DepartmentalSessions, b.DepartmentalSessions) &&
+           sameGroups(a.Reinforcements, b.Reinforcements) && sameGroups(a.Guidance, b.Guidance) &&
+           sameGroups(a.OptionalColloquium, b.OptionalColloquium) && sameGroups(a.Registration, b.Registration) &&
+           sameGroups(a.Thesis, b.Thesis) && sameGroups(a.Project, b.Project) &&
+           sameGroups(a.Tirgulim, b.Tirgulim) && sameGroups(a.labs, b.labs) && sameGroups(a.blocks, b.blocks);
+}
+
+// True if every session of the old option is also in the new one, so the new option conflicts with
+// everything the old one did
+bool coversSessions(const CourseSelection& newer, const CourseSelection& older) {
+    vector<const Session*> newSessions = getSessions(newer);
+    for (const Session* oldSession : getSessions(older)) {
+        bool found = false;
+        for (const Session* newSession : newSessions) {
+            if (sameSession(*oldSession, *newSession)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+bool ScheduleBuilder::extendCompact(const ScheduleSet& previous, const vector<Course>& courses, const string& semester,
+                                    vector<InformativeSchedule>& results,
+                                    const function<bool(const vector<InformativeSchedule>&)>& onChunk) {
+    // A limited previous result may miss schedules the extension would have to produce
+    if (!previous.complete || constraints.active()) {
+        return false;
+    }
+
+    bool streaming = false;
+
+    try {
+        unordered_map<int, size_t> previousIndex;
+        for (size_t i = 0; i < previous.courses.size(); i++) {
+            if (!previousIndex.emplace(previous.courses[i].id, i).second) return false;
+        }
+
+        // fromPrevious[j] = position of course j in the previous set, or -1 for the added course
+        vector<int> fromPrevious(courses.size(), -1);
+        vector<bool> narrowed(courses.size(), false);
+        int added = -1;
+        unordered_set<int> seen;
+
+        for (size_t j = 0; j < courses.size(); j++) {
+            if (!seen.insert(courses[j].id).second) return false;
+
+            auto it = previousIndex.find(courses[j].id);
+            if (it == previousIndex.end()) {
+                if (added != -1) return false;
+                added = static_cast<int>(j);
+                continue;
+            }
+
+            fromPrevious[j] = static_cast<int>(it->second);
+            narrowed[j] = !sameCourse(previous.courses[it->second], courses[j]);
+        }
+
+        // Removing a course can only add schedules, which needs a full search
+        if (seen.size() - (added != -1 ? 1 : 0) != previous.courses.size()) {
+            return false;
+        }
+
+        auto set = make_shared<ScheduleSet>(courses);
+        CourseLegalComb generator;
+        for (const auto& course : set->courses) {
+            set->options.push_back(generator.generate(course));
+        }
+
+        for (size_t j = 0; j < courses.size(); j++) {
+            if (fromPrevious[j] == -1) continue;
+
+            const auto& oldOptions = previous.options[fromPrevious[j]];
+            if (!narrowed[j]) {
+                if (set->options[j].size() != oldOptions.size()) return false;
+            } else if (set->options[j].size() != 1 || oldOptions.size() != 1 ||
+                       !coversSessions(set->options[j][0], oldOptions[0])) {
+                return false;
+            }
+        }
+
+        Logger::get().logInfo("Extending " + to_string(previous.size()) + " previous schedules to " +
+                              to_string(courses.size()) + " courses in semester " + semester);
+
+        // Remap, filter and extend the previous tuples; they were in lexicographic order before and
+        // are sorted again so the result matches a full build
+        const size_t previousWidth = previous.options.size();
+        vector<vector<int>> tuples;
+        vector<int> tuple(courses.size(), -1);
+
+        for (size_t p = 0; p < previous.size(); p++) {
+            const uint32_t* previousTuple = previous.tuples.data() + p * previousWidth;
+            for (size_t j = 0; j < courses.size(); j++) {
+                tuple[j] = fromPrevious[j] == -1 ? -1 : static_cast<int>(previousTuple[fromPrevious[j]]);
+            }
+
+            bool valid = true;
+            for (size_t j = 0; j < courses.size() && valid; j++) {
+                if (!narrowed[j]) continue;
+                for (size_t other = 0; other < courses.size() && valid; other++) {
+                    if (other == j || tuple[other] == -1) continue;
+                    valid = !CompatibilityMatrix::hasConflict(set->options[j][tuple[j]],
+                                                              set->options[other][tuple[other]]);
+                }
+            }
+            if (!valid) continue;
+
+            if (added == -1) {
+                tuples.push_back(tuple);
+                continue;
+            }
+
+            for (size_t option = 0; option < set->options[added].size(); option++) {
+                bool compatible = true;
+                for (size_t other = 0; other < courses.size() && compatible; other++) {
+                    if (static_cast<int>(other) == added) continue;
+                    compatible = !CompatibilityMatrix::hasConflict(set->options[added][option],
+                                                                   set->options[other][tuple[other]]);
+                }
+                if (compatible) {
+                    tuples.push_back(tuple);
+                    tuples.back()[added] = static_cast<int>(option);
+                }
+            }
+        }
+
+        if (collapseEquivalent) {
+            // Order of an equivalence-class build: by class tuple, then by the options themselves
+            OptionClasses newClasses = buildOptionClasses(set->options);
+            sort(tuples.begin(), tuples.end(), [&newClasses](const vector<int>& a, const vector<int>& b) {
+                for (size_t course = 0; course < a.size(); course++) {
+                    int classA = newClasses.classOf[course][a[course]];
+                    int classB = newClasses.classOf[course][b[course]];
+                    if (classA != classB) return classA < classB;
+                }
+                return a < b;
+            });
+        } else {
+            sort(tuples.begin(), tuples.end());
+        }
+        bool truncated = maxSchedules > 0 && tuples.size() > maxSchedules;
+        if (truncated) {
+            tuples.resize(maxSchedules);
+        }
+
+        // Session strings are keyed by the sessions the set's options point into
+        prepareGeneration(set->courses, semester);
+
+        TupleChunkCallback sink = compactSink(set, results, onChunk);
+        openStream(sink, semester, DEFAULT_CHUNK_SIZE, true);
+        streaming = true;
+        materializeTuples(tuples, set->options);
+        {
+            lock_guard<mutex> lock(stream.streamMutex);
+            if (!stopRequested) {
+                queuePendingLocked();
+            }
+        }
+        emitReady();
+        set->complete = !truncated && !stopRequested;
+        closeStream();
+
+        lastSet = set;
+        Logger::get().logInfo("Finished incremental schedule generation for semester " + semester +
+                              ". Total valid schedules: " + to_string(results.size()));
+        return true;
+
+    } catch (const exception& e) {
+        Logger::get().logError("Exception in ScheduleBuilder::extendCompact: " + string(e.what()));
+        if (!streaming) {
+            return false;
+        }
+
+        // Chunks already reached the consumer; keep the partial result rather than building twice
+        closeStream();
+        return true;
+    }
+}
+
+size_t ScheduleBuilder::generate(const vector<Course>& courses, const string& semester,
+                                 vector<vector<CourseSelection>>& allOptions, const TupleChunkCallback& onChunk,
+                                 size_t chunkSize, bool keepTuples) {
     Logger::get().logInfo("Starting schedule generation for " + to_string(courses.size()) +
                           " courses in semester " + semester);
 
-    currentSemester = semester;
-    vector<InformativeSchedule> results;
     totalSchedulesGenerated = 0;
+    openStream(onChunk, semester, chunkSize, keepTuples);
 
     try {
-        buildCourseInfoMap(courses);
+        prepareGeneration(courses, semester);
 
         CourseLegalComb generator;
-        vector<vector<CourseSelection>> allOptions;
+        allOptions.clear();
 
         // Generate combinations for each course
         for (const auto& course : courses) {
@@ -30,208 +301,1037 @@ vector<InformativeSchedule> ScheduleBuilder::build(const vector<Course>& courses
             allOptions.push_back(std::move(combinations));
         }
 
-        // SAFETY: Estimate and limit total possible schedules to prevent memory exhaustion
+        if (constraints.active()) {
+            removeExcludedOptions(allOptions);
+        }
+
         long long estimatedTotal = 1;
         for (const auto& options : allOptions) {
             estimatedTotal *= options.size();
-            if (estimatedTotal > 100000) {  // Reduced limit for safety
+            if (maxSchedules > 0 && estimatedTotal > static_cast<long long>(maxSchedules)) {
                 Logger::get().logWarning("Estimated schedules (" + to_string(estimatedTotal) +
-                                         ") exceeds safe limit. Generation may be limited.");
+                                         ") exceeds the limit of " + to_string(maxSchedules) +
+                                         ". Generation will be limited.");
                 break;
             }
         }
 
         Logger::get().logInfo("Estimated maximum schedules: " + to_string(estimatedTotal));
 
-        // SAFETY: Reserve memory upfront and set hard limit
-        try {
-            results.reserve(min(estimatedTotal, 50000LL));  // Hard limit of 50k schedules
-        } catch (const std::bad_alloc& e) {
-            Logger::get().logError("Failed to reserve memory for schedules: " + string(e.what()));
-            return results;  // Return empty if can't allocate
+        // Equivalent options share one branch and are expanded at materialization
+        const vector<vector<CourseSelection>>* searchOptions = &allOptions;
+        classes = OptionClasses();
+        if (collapseEquivalent) {
+            classes = buildOptionClasses(allOptions);
+            searchOptions = &classes.representatives;
+
+            size_t optionCount = 0, classCount = 0;
+            for (size_t course = 0; course < allOptions.size(); course++) {
+                optionCount += allOptions[course].size();
+                classCount += classes.representatives[course].size();
+            }
+            Logger::get().logInfo("Collapsed " + to_string(optionCount) + " options into " +
+                                  to_string(classCount) + " time-equivalent classes");
         }
 
-        vector<CourseSelection> current;
-        backtrack(0, allOptions, current, results);
+        compatibility.build(*searchOptions);
+        prepareConstraints(*searchOptions);
+        enumerateParallel(*searchOptions);
 
         Logger::get().logInfo("Finished schedule generation for semester " + semester +
-                              ". Total valid schedules: " + to_string(results.size()));
+                              ". Total valid schedules: " + to_string(stream.emitted));
 
     } catch (const std::bad_alloc& e) {
         Logger::get().logError("Out of memory during schedule generation: " + string(e.what()));
-        results.clear();  // Clear partial results to free memory
+        stopRequested = true;
     } catch (const exception& e) {
         Logger::get().logError("Exception in ScheduleBuilder::build: " + string(e.what()));
+        stopRequested = true;
     }
 
-    return results;
+    closeStream();
+    classes = OptionClasses();
+    return stream.emitted;
 }
 
-void ScheduleBuilder::backtrack(int currentCourse, const vector<vector<CourseSelection>>& allOptions,
-                                vector<CourseSelection>& currentCombination, vector<InformativeSchedule>& results) {
-    try {
-        // SAFETY: Check if we've generated too many schedules
-        if (results.size() >= 50000) {  // Hard limit
-            Logger::get().logWarning("Reached maximum schedule limit (50,000). Stopping generation.");
-            return;
-        }
+ScheduleBuilder::OptionClasses ScheduleBuilder::buildOptionClasses(const vector<vector<CourseSelection>>& allOptions) {
+    OptionClasses result;
+    result.active = true;
+    result.options = &allOptions;
+    result.representatives.resize(allOptions.size());
+    result.members.resize(allOptions.size());
+    result.classOf.resize(allOptions.size());
 
-        if (currentCourse == allOptions.size()) {
-            InformativeSchedule schedule = convertToInformativeSchedule(currentCombination, results.size());
-            results.push_back(schedule);
-            totalSchedulesGenerated++;
+    for (size_t course = 0; course < allOptions.size(); course++) {
+        map<vector<array<int, 3>>, int> classByTimes;
 
-            // Log progress for large generations
-            if (totalSchedulesGenerated % 1000 == 0) {
-                Logger::get().logInfo("Generated " + to_string(totalSchedulesGenerated) + " schedules so far...");
+        for (size_t option = 0; option < allOptions[course].size(); option++) {
+            const CourseSelection& selection = allOptions[course][option];
+
+            vector<array<int, 3>> times;
+            for (const SessionTime& time : selection.sessionTimes) {
+                times.push_back({time.day, time.start, time.end});
             }
+            sort(times.begin(), times.end());
 
-            return;
+            auto inserted = classByTimes.emplace(std::move(times), static_cast<int>(result.members[course].size()));
+            if (inserted.second) {
+                result.representatives[course].push_back(selection);
+                result.members[course].emplace_back();
+            }
+            result.members[course][inserted.first->second].push_back(static_cast<int>(option));
+            result.classOf[course].push_back(inserted.first->second);
         }
+    }
+    return result;
+}
 
-        for (const auto& option : allOptions[currentCourse]) {
-            bool conflict = false;
+bool ScheduleBuilder::forEachVariant(const vector<int>& chosen, const function<bool(const vector<int>&)>& visit) const {
+    if (!classes.active || chosen.empty()) {
+        return visit(chosen);
+    }
 
-            for (const auto& selected : currentCombination) {
-                if (hasConflict(option, selected)) {
-                    conflict = true;
-                    break;
-                }
-            }
+    const int courseCount = static_cast<int>(chosen.size());
+    vector<size_t> position(courseCount, 0);
+    vector<int> tuple(courseCount);
+    for (int course = 0; course < courseCount; course++) {
+        tuple[course] = classes.members[course][chosen[course]][0];
+    }
 
-            if (!conflict) {
-                currentCombination.push_back(option);
-                backtrack(currentCourse + 1, allOptions, currentCombination, results);
-                currentCombination.pop_back();
+    while (visit(tuple)) {
+        // Odometer over the class members, last course fastest
+        int course = courseCount - 1;
+        for (; course >= 0; course--) {
+            const vector<int>& members = classes.members[course][chosen[course]];
+            if (++position[course] < members.size()) {
+                tuple[course] = members[position[course]];
+                break;
             }
+            position[course] = 0;
+            tuple[course] = members[0];
         }
-    } catch (const std::bad_alloc& e) {
-        Logger::get().logError("Out of memory in backtrack: " + string(e.what()));
-        return;  // Stop generation
-    } catch (const exception& e) {
-        Logger::get().logError("Exception in ScheduleBuilder::backtrack: " + string(e.what()));
+        if (course < 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Generation constraints
+
+void ScheduleBuilder::removeExcludedOptions(vector<vector<CourseSelection>>& allOptions) const {
+    array<bool, 8> forbidden{};
+    for (int day : constraints.forbiddenDays) {
+        if (day >= 1 && day <= 7) forbidden[day] = true;
+    }
+
+    size_t removed = 0;
+    for (auto& options : allOptions) {
+        size_t before = options.size();
+        options.erase(remove_if(options.begin(), options.end(), [&](const CourseSelection& option) {
+            for (const SessionTime& time : option.sessionTimes) {
+                if (time.day >= 1 && time.day <= 7 && forbidden[time.day]) return true;
+                if (constraints.earliestStart >= 0 && time.start < constraints.earliestStart) return true;
+                if (constraints.latestEnd >= 0 && time.end > constraints.latestEnd) return true;
+            }
+            return false;
+        }), options.end());
+        removed += before - options.size();
     }
+
+    Logger::get().logInfo("Constraints removed " + to_string(removed) + " course options");
 }
 
-bool ScheduleBuilder::hasConflict(const CourseSelection& a, const CourseSelection& b) {
-    vector<const Session*> aSessions = getSessions(a);
-    vector<const Session*> bSessions = getSessions(b);
+void ScheduleBuilder::prepareConstraints(const vector<vector<CourseSelection>>& searchOptions) {
+    constraintCoverage.assign(searchOptions.size(), WeekMask());
+    if (!constraints.limitsGaps()) return;
 
-    // Compare each session in a with each session in b
-    for (const auto* s1 : aSessions) {
-        for (const auto* s2 : bSessions) {
-            if (TimeUtils::isOverlap(s1, s2)) return true;
+    for (size_t course = 0; course < searchOptions.size(); course++) {
+        for (const auto& option : searchOptions[course]) {
+            constraintCoverage[course].merge(option.occupancy);
         }
     }
-    return false;
 }
 
-// Course map helpers
+bool ScheduleBuilder::withinConstraints(const SearchState& state) const {
+    const MetricsAccumulator& metrics = state.metrics;
 
-void ScheduleBuilder::buildCourseInfoMap(const vector<Course>& courses) {
-    std::lock_guard<std::mutex> lock(courseInfoMapMutex);
-    courseInfoMap.clear();
-    for (const auto& course : courses) {
-        courseInfoMap[course.id] = {course.raw_id, course.name};
+    if (constraints.maxDays >= 0 && metrics.daysUsed() > constraints.maxDays) {
+        return false;
+    }
+    if (!constraints.limitsGaps()) {
+        return true;
+    }
+
+    // A gap is final once no unassigned course has a session that could land inside it
+    WeekMask remaining;
+    bool complete = true;
+    for (size_t course = 0; course < state.chosen.size(); course++) {
+        if (state.chosen[course] == -1) {
+            remaining.merge(constraintCoverage[course]);
+            complete = false;
+        }
+    }
+    if (!remaining.exact) {
+        return true;
+    }
+
+    int gaps = 0;
+    for (int day = 1; day <= 7; day++) {
+        for (int i = 0; i + 1 < metrics.count(day); i++) {
+            int gapStart = metrics.session(day, i).second;
+            int gapEnd = metrics.session(day, i + 1).first;
+            if (gapEnd - gapStart < 30) continue;
+            if (!complete && remaining.intersectsRange(day, gapStart, gapEnd)) continue;
+
+            if (constraints.maxGapTime >= 0 && gapEnd - gapStart > constraints.maxGapTime) return false;
+            if (constraints.maxGaps >= 0 && ++gaps > constraints.maxGaps) return false;
+        }
     }
+    return true;
 }
 
-string ScheduleBuilder::getCourseNameById(int courseId) {
-    lock_guard<mutex> lock(courseInfoMapMutex);
-    auto it = courseInfoMap.find(courseId);
-    if (it != courseInfoMap.end()) {
-        return it->second.name;
+void ScheduleBuilder::openStream(const TupleChunkCallback& onChunk, const string& semester, size_t chunkSize,
+                                 bool keepTuples) {
+    stopRequested = false;
+
+    stream.onChunk = &onChunk;
+    stream.semester = semester;
+    stream.ids = ScheduleId(semester);
+    stream.chunkSize = chunkSize > 0 ? chunkSize : 1;
+    stream.keepTuples = keepTuples;
+    stream.delivered = 0;
+    stream.emitted = 0;
+    stream.pending.clear();
+    stream.pendingTuples.clear();
+    stream.ready.clear();
+    stream.emitting = false;
+    stream.consumerStopped = false;
+}
+
+void ScheduleBuilder::closeStream() {
+    stream.onChunk = nullptr;
+    stream.outputs = nullptr;
+    stream.pending.clear();
+    stream.pendingTuples.clear();
+    stream.ready.clear();
+}
+
+ScheduleBuilder::SearchState ScheduleBuilder::makeSearchState(const vector<vector<CourseSelection>>& allOptions) const {
+    SearchState state;
+    state.chosen.assign(allOptions.size(), -1);
+    state.candidates.assign(allOptions.size() + 1, vector<OptionBitset>(allOptions.size()));
+
+    for (size_t course = 0; course < allOptions.size(); course++) {
+        state.candidates[0][course] = compatibility.allOptionsOf(course);
     }
-    return "Unknown Course";
+    return state;
 }
 
-string ScheduleBuilder::getCourseRawIdById(int courseId) {
-    lock_guard<mutex> lock(courseInfoMapMutex);
-    auto it = courseInfoMap.find(courseId);
-    if (it != courseInfoMap.end()) {
-        return it->second.raw_id;
+size_t ScheduleBuilder::nextCourse(const SearchState& state, size_t depth) const {
+    if (!constraintPropagation) {
+        return depth;
     }
-    return "Unknown ID";
+
+    // Most constrained first; ties go to the earlier course to keep the search deterministic
+    size_t best = state.chosen.size();
+    size_t bestCount = SIZE_MAX;
+    for (size_t course = 0; course < state.chosen.size(); course++) {
+        if (state.chosen[course] != -1) continue;
+
+        size_t count = CompatibilityMatrix::countOptions(state.candidates[depth][course]);
+        if (count < bestCount) {
+            best = course;
+            bestCount = count;
+        }
+    }
+    return best;
 }
 
-// Convert to informative schedule and calculate metadata
+bool ScheduleBuilder::choose(SearchState& state, size_t depth, size_t course, size_t option) const {
+    const vector<OptionBitset>& above = state.candidates[depth];
+    vector<OptionBitset>& below = state.candidates[depth + 1];
 
-InformativeSchedule ScheduleBuilder::convertToInformativeSchedule(const vector<CourseSelection>& selections, int index) {
-    InformativeSchedule schedule;
-    schedule.index = index;
-    schedule.semester = currentSemester;
+    state.chosen[course] = static_cast<int>(option);
 
-    // NEW: Generate unique ID for this schedule
-    schedule.unique_id = generateUniqueScheduleId(currentSemester, index);
+    for (size_t other = 0; other < state.chosen.size(); other++) {
+        if (state.chosen[other] != -1) continue;
 
-    try {
-        map<int, vector<ScheduleItem>> daySchedules;
-        const vector<string> dayNames = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+        const uint64_t* compatible = compatibility.compatible(course, option, other);
+        below[other].resize(above[other].size());
+        uint64_t remaining = 0;
+        for (size_t w = 0; w < above[other].size(); w++) {
+            below[other][w] = above[other][w] & compatible[w];
+            remaining |= below[other][w];
+        }
 
-        for (const auto& selection : selections) {
-            if (selection.lectureGroup) {
-                processGroupSessions(selection, selection.lectureGroup, "Lecture", daySchedules);
-            }
+        if (constraintPropagation && remaining == 0) {
+            state.chosen[course] = -1;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ScheduleBuilder::collectPrefixes(SearchState& state, size_t depth, size_t splitDepth,
+                                      vector<pair<size_t, size_t>>& prefix,
+                                      vector<vector<pair<size_t, size_t>>>& prefixes) const {
+    if (depth == splitDepth) {
+        prefixes.push_back(prefix);
+        return;
+    }
+
+    size_t course = nextCourse(state, depth);
+    const OptionBitset& candidates = state.candidates[depth][course];
 
-            if (selection.tutorialGroup) {
-                processGroupSessions(selection, selection.tutorialGroup, "Tutorial", daySchedules);
+    for (size_t w = 0; w < candidates.size(); w++) {
+        uint64_t word = candidates[w];
+        while (word) {
+            size_t option = w * 64 + CompatibilityMatrix::lowestBit(word);
+            word &= word - 1;
+
+            if (choose(state, depth, course, option)) {
+                prefix.emplace_back(course, option);
+                collectPrefixes(state, depth + 1, splitDepth, prefix, prefixes);
+                prefix.pop_back();
             }
+            state.chosen[course] = -1;
+        }
+    }
+}
 
-            if (selection.labGroup) {
-                processGroupSessions(selection, selection.labGroup, "Lab", daySchedules);
+void ScheduleBuilder::enumerateParallel(const vector<vector<CourseSelection>>& allOptions) {
+    const size_t courseCount = allOptions.size();
+
+    // A single task holding the whole tree runs the serial search on the calling thread. Otherwise
+    // split at the second level too when the first one does not give every thread enough tasks.
+    size_t splitDepth = 0;
+    if (threadCount > 1 && courseCount > 0) {
+        splitDepth = (courseCount >= 2 && allOptions[0].size() < threadCount * 4) ? 2 : 1;
+    }
+
+    vector<vector<pair<size_t, size_t>>> prefixes;
+    vector<pair<size_t, size_t>> prefix;
+    SearchState rootState = makeSearchState(allOptions);
+    collectPrefixes(rootState, 0, splitDepth, prefix, prefixes);
+
+    vector<SearchOutput> outputs(prefixes.size());
+    for (size_t t = 0; t < outputs.size(); t++) {
+        outputs[t].task = t;
+    }
+
+    stream.outputs = &outputs;
+    stream.headTask = 0;
+    stream.taskFinished.assign(prefixes.size(), false);
+    stream.window = static_cast<size_t>(threadCount) * 4;
+
+    vector<function<void()>> tasks;
+    tasks.reserve(prefixes.size());
+
+    for (size_t t = 0; t < prefixes.size(); t++) {
+        tasks.emplace_back([&, t]() {
+            // Every exit has to release the ordered stream, or the tasks waiting behind this one
+            // never wake up and the pool never returns
+            try {
+                // With a dynamic order every subtree may hold early tuples, so there is nothing to
+                // stream until all tasks are done
+                if (!constraintPropagation) {
+                    waitForTurn(t);
+                }
+
+                if (!stopRequested) {
+                    SearchState state = makeSearchState(allOptions);
+                    for (size_t depth = 0; depth < prefixes[t].size(); depth++) {
+                        choose(state, depth, prefixes[t][depth].first, prefixes[t][depth].second);
+                        state.metrics.push(allOptions[prefixes[t][depth].first][prefixes[t][depth].second]);
+                    }
+
+                    backtrack(static_cast<int>(splitDepth), allOptions, state, outputs[t]);
+                }
+
+                if (!constraintPropagation) {
+                    flushOutput(outputs[t], true);
+                }
+            } catch (const std::bad_alloc& e) {
+                Logger::get().logError("Out of memory in search task: " + string(e.what()));
+                requestStop();
+            } catch (const exception& e) {
+                Logger::get().logError("Exception in search task: " + string(e.what()));
+                requestStop();
+            } catch (...) {
+                Logger::get().logError("Unknown exception in search task");
+                requestStop();
             }
+        });
+    }
 
-            if (selection.blockGroup) {
-                processGroupSessions(selection, selection.blockGroup, "Block", daySchedules);
+    WorkStealingPool pool(threadCount);
+    pool.run(tasks);
+
+    if (constraintPropagation) {
+        // Deterministic reordering: the smallest tuples in course order are exactly the schedules
+        // the static backtracker would have produced first
+        vector<vector<int>> tuples;
+        for (auto& output : outputs) {
+            while (!output.tuples.empty()) {
+                tuples.push_back(output.tuples.top());
+                output.tuples.pop();
+            }
+        }
+        sort(tuples.begin(), tuples.end());
+
+        // Every representative tuple stands for at least one schedule, so the limit still holds
+        if (classes.active) {
+            vector<vector<int>> variants;
+            for (const auto& tuple : tuples) {
+                bool more = forEachVariant(tuple, [&](const vector<int>& variant) {
+                    variants.push_back(variant);
+                    return maxSchedules == 0 || variants.size() < maxSchedules;
+                });
+                if (!more) break;
             }
+            tuples.swap(variants);
+        }
+
+        if (maxSchedules > 0 && tuples.size() > maxSchedules) {
+            tuples.resize(maxSchedules);
+        }
+        materializeTuples(tuples, outputOptions(allOptions));
+    }
+
+    // Remainder smaller than a full chunk
+    {
+        lock_guard<mutex> lock(stream.streamMutex);
+        if (!stopRequested) {
+            queuePendingLocked();
+        }
+    }
+    emitReady();
+}
+
+void ScheduleBuilder::waitForTurn(size_t task) {
+    unique_lock<mutex> lock(stream.streamMutex);
+    stream.headAdvanced.wait(lock, [&]() {
+        return stopRequested || task < stream.headTask + stream.window;
+    });
+}
+
+void ScheduleBuilder::flushOutput(SearchOutput& output, bool finished) {
+    deliverOutput(output, finished);
+    emitReady();
+}
+
+void ScheduleBuilder::deliverOutput(SearchOutput& output, bool finished) {
+    unique_lock<mutex> lock(stream.streamMutex);
+
+    if (output.task != stream.headTask) {
+        if (finished) {
+            stream.taskFinished[output.task] = true;
+            return;
+        }
+        stream.headAdvanced.wait(lock, [&]() {
+            return stopRequested || stream.headTask == output.task;
+        });
+    }
+
+    if (stopRequested) {
+        output.schedules.clear();
+        output.scheduleTuples.clear();
+        if (finished) {
+            stream.taskFinished[output.task] = true;
+        }
+        stream.headAdvanced.notify_all();
+        return;
+    }
+
+    deliverLocked(output.schedules, output.scheduleTuples);
+
+    if (finished) {
+        stream.taskFinished[output.task] = true;
+        stream.headTask++;
+
+        // Hand over the buffers of tasks that finished while waiting behind this one
+        while (stream.headTask < stream.taskFinished.size() && stream.taskFinished[stream.headTask]) {
+            SearchOutput& parked = (*stream.outputs)[stream.headTask];
+            deliverLocked(parked.schedules, parked.scheduleTuples);
+            stream.headTask++;
+        }
+        stream.headAdvanced.notify_all();
+    }
+}
+
+void ScheduleBuilder::deliverLocked(vector<InformativeSchedule>& schedules, vector<vector<int>>& tuples) {
+    // Indices and IDs are assigned on delivery so they follow the serial DFS order
+    for (size_t i = 0; i < schedules.size(); i++) {
+        if (stopRequested) break;
+
+        InformativeSchedule& schedule = schedules[i];
+        schedule.index = static_cast<int>(stream.delivered);
+        schedule.unique_id = stream.ids.idOf(schedule.index);
+        schedule.unique_key = stream.ids.keyOf(schedule.index);
+        stream.pending.push_back(std::move(schedule));
+        if (stream.keepTuples) {
+            stream.pendingTuples.push_back(std::move(tuples[i]));
+        }
+        stream.delivered++;
+
+        bool limitReached = maxSchedules > 0 && stream.delivered >= maxSchedules;
+        if (stream.pending.size() >= stream.chunkSize || limitReached) {
+            queuePendingLocked();
+        }
+        if (limitReached) {
+            Logger::get().logWarning("Reached maximum schedule limit (" + to_string(maxSchedules) +
+                                     "). Stopping generation.");
+            stopRequested = true;
+        }
+    }
+    schedules.clear();
+    tuples.clear();
+
+    if (stopRequested) {
+        stream.headAdvanced.notify_all();
+    }
+}
+
+void ScheduleBuilder::queuePendingLocked() {
+    if (stream.pending.empty()) return;
 
-            if (selection.departmentalGroup) {
-                processGroupSessions(selection, selection.departmentalGroup, "Departmental", daySchedules);
+    stream.ready.emplace_back(std::move(stream.pending), std::move(stream.pendingTuples));
+    stream.pending.clear();
+    stream.pendingTuples.clear();
+}
+
+void ScheduleBuilder::emitReady() {
+    unique_lock<mutex> lock(stream.streamMutex);
+    if (stream.emitting) {
+        // The running emitter drains the queue; only hold the producer back once it runs ahead
+        stream.chunkEmitted.wait(lock, [&]() {
+            return !stream.emitting || stream.consumerStopped ||
+                   stream.ready.size() <= ScheduleStream::MAX_READY_CHUNKS;
+        });
+        return;
+    }
+
+    stream.emitting = true;
+    while (!stream.ready.empty() && !stream.consumerStopped) {
+        auto chunk = std::move(stream.ready.front());
+        stream.ready.pop_front();
+        lock.unlock();
+
+        bool keepGoing;
+        try {
+            keepGoing = (*stream.onChunk)(chunk.first, chunk.second);
+        } catch (const exception& e) {
+            Logger::get().logError("Exception in schedule consumer: " + string(e.what()));
+            keepGoing = false;
+        } catch (...) {
+            // Left to the caller, as before, once the stream is consistent again
+            lock.lock();
+            stream.emitted += chunk.first.size();
+            stream.consumerStopped = true;
+            stream.emitting = false;
+            stream.ready.clear();
+            stopRequested = true;
+            stream.headAdvanced.notify_all();
+            stream.chunkEmitted.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        stream.emitted += chunk.first.size();
+        if (!keepGoing) {
+            stream.consumerStopped = true;
+            stopRequested = true;
+            stream.headAdvanced.notify_all();
+        }
+        stream.chunkEmitted.notify_all();
+    }
+
+    // Chunks queued before the consumer stopped are dropped, as the search itself stops
+    if (stream.consumerStopped) {
+        stream.ready.clear();
+    }
+    stream.emitting = false;
+    stream.chunkEmitted.notify_all();
+}
+
+void ScheduleBuilder::requestStop() {
+    lock_guard<mutex> lock(stream.streamMutex);
+    stopRequested = true;
+    stream.headAdvanced.notify_all();
+}
+
+void ScheduleBuilder::backtrack(int depth, const vector<vector<CourseSelection>>& allOptions,
+                                SearchState& state, SearchOutput& output) {
+    try {
+        if (stopRequested) {
+            return;
+        }
+
+        if (constraints.active() && !withinConstraints(state)) {
+            return;
+        }
+
+        if (depth == allOptions.size()) {
+            if (constraintPropagation) {
+                int generated = ++totalSchedulesGenerated;
+                if (generated % 1000 == 0) {
+                    Logger::get().logInfo("Generated " + to_string(generated) + " schedules so far...");
+                }
+
+                // Keep only the maxSchedules smallest tuples seen by this task
+                if (maxSchedules == 0 || output.tuples.size() < maxSchedules) {
+                    output.tuples.push(state.chosen);
+                } else if (state.chosen < output.tuples.top()) {
+                    output.tuples.pop();
+                    output.tuples.push(state.chosen);
+                }
+            } else {
+                const vector<vector<CourseSelection>>& options = outputOptions(allOptions);
+
+                forEachVariant(state.chosen, [&](const vector<int>& tuple) {
+                    vector<const CourseSelection*> selections;
+                    selections.reserve(options.size());
+                    for (size_t course = 0; course < options.size(); course++) {
+                        selections.push_back(&options[course][tuple[course]]);
+                    }
+
+                    // Room variants share the session times, so the path's metrics hold for each
+                    output.schedules.push_back(convertToInformativeSchedule(selections, 0, &state.metrics,
+                                                                            !stream.keepTuples));
+                    if (stream.keepTuples) {
+                        output.scheduleTuples.push_back(tuple);
+                    }
+                    if (output.schedules.size() >= stream.chunkSize) {
+                        flushOutput(output, false);
+                    }
+
+                    // Log progress for large generations
+                    int generated = ++totalSchedulesGenerated;
+                    if (generated % 1000 == 0) {
+                        Logger::get().logInfo("Generated " + to_string(generated) + " schedules so far...");
+                    }
+                    return !stopRequested;
+                });
             }
 
-            if (selection.reinforcementGroup) {
-                processGroupSessions(selection, selection.reinforcementGroup, "Reinforcement", daySchedules);
+            return;
+        }
+
+        size_t course = nextCourse(state, depth);
+
+        // Only options compatible with every course chosen so far are left in the candidate set
+        const OptionBitset& candidates = state.candidates[depth][course];
+
+        for (size_t w = 0; w < candidates.size(); w++) {
+            uint64_t word = candidates[w];
+            while (word) {
+                size_t option = w * 64 + CompatibilityMatrix::lowestBit(word);
+                word &= word - 1;
+
+                if (choose(state, depth, course, option)) {
+                    state.metrics.push(allOptions[course][option]);
+                    backtrack(depth + 1, allOptions, state, output);
+                    state.metrics.pop();
+                }
+                state.chosen[course] = -1;
             }
+        }
+    } catch (const std::bad_alloc& e) {
+        Logger::get().logError("Out of memory in backtrack: " + string(e.what()));
+        requestStop();
+        return;  // Stop generation
+    } catch (const exception& e) {
+        Logger::get().logError("Exception in ScheduleBuilder::backtrack: " + string(e.what()));
+    }
+}
+
+void ScheduleBuilder::materializeTuples(const vector<vector<int>>& tuples,
+                                        const vector<vector<CourseSelection>>& allOptions) {
+    // Each round materializes one chunk per thread in parallel, then streams them in order
+    const size_t chunkSize = stream.chunkSize;
+    const size_t roundSize = chunkSize * threadCount;
+
+    for (size_t roundBegin = 0; roundBegin < tuples.size() && !stopRequested; roundBegin += roundSize) {
+        size_t roundEnd = min(tuples.size(), roundBegin + roundSize);
+        vector<vector<InformativeSchedule>> chunks((roundEnd - roundBegin + chunkSize - 1) / chunkSize);
+        vector<vector<vector<int>>> chunkTuples(chunks.size());
+
+        vector<function<void()>> tasks;
+        for (size_t c = 0; c < chunks.size(); c++) {
+            tasks.emplace_back([&, c]() {
+                size_t begin = roundBegin + c * chunkSize;
+                size_t end = min(roundEnd, begin + chunkSize);
+                chunks[c].reserve(end - begin);
+
+                for (size_t i = begin; i < end; i++) {
+                    vector<const CourseSelection*> selections;
+                    selections.reserve(allOptions.size());
+                    for (size_t course = 0; course < allOptions.size(); course++) {
+                        selections.push_back(&allOptions[course][tuples[i][course]]);
+                    }
+                    chunks[c].push_back(convertToInformativeSchedule(selections, 0, nullptr, !stream.keepTuples));
+                    if (stream.keepTuples) {
+                        chunkTuples[c].push_back(tuples[i]);
+                    }
+                }
+            });
+        }
+
+        WorkStealingPool pool(threadCount);
+        pool.run(tasks);
 
-            if (selection.guidanceGroup) {
-                processGroupSessions(selection, selection.guidanceGroup, "Guidance", daySchedules);
+        {
+            lock_guard<mutex> lock(stream.streamMutex);
+            for (size_t c = 0; c < chunks.size(); c++) {
+                deliverLocked(chunks[c], chunkTuples[c]);
             }
+        }
+        emitReady();
+    }
+}
 
-            if (selection.colloquiumGroup) {
-                processGroupSessions(selection, selection.colloquiumGroup, "Colloquium", daySchedules);
+// Top-K search
+
+vector<InformativeSchedule> ScheduleBuilder::buildTopK(const vector<Course>& courses, const string& semester,
+                                                       const ScheduleObjective& objective, size_t k) {
+    Logger::get().logInfo("Starting top-" + to_string(k) + " schedule search for " + to_string(courses.size()) +
+                          " courses in semester " + semester);
+
+    totalSchedulesGenerated = 0;
+    stopRequested = false;
+    vector<InformativeSchedule> results;
+
+    if (k == 0) {
+        return results;
+    }
+
+    try {
+        prepareGeneration(courses, semester);
+
+        CourseLegalComb generator;
+        vector<vector<CourseSelection>> allOptions;
+        for (const auto& course : courses) {
+            allOptions.push_back(generator.generate(course));
+        }
+
+        if (constraints.active()) {
+            removeExcludedOptions(allOptions);
+        }
+
+        compatibility.build(allOptions);
+        prepareConstraints(allOptions);
+
+        TopKSearch search;
+        search.objective = &objective;
+        search.k = k;
+        search.profiles.resize(allOptions.size());
+        search.remainingCoverage.assign(allOptions.size() + 1, WeekMask());
+        search.remainingMinClassTime.assign(allOptions.size() + 1, 0);
+
+        for (size_t course = 0; course < allOptions.size(); course++) {
+            for (const auto& option : allOptions[course]) {
+                OptionProfile profile;
+                for (const SessionTime& time : option.sessionTimes) {
+                    if (time.day < 1 || time.day > 7) continue;
+
+                    profile.sessions.push_back({time.day, time.start, time.end});
+                    profile.classTime += time.end - time.start;
+                }
+                search.orderedTimes = search.orderedTimes && option.occupancy.exact;
+
+                // Groups are not checked against themselves, so an option may overlap itself
+                sort(profile.sessions.begin(), profile.sessions.end());
+                for (size_t i = 1; i < profile.sessions.size(); i++) {
+                    if (profile.sessions[i][0] == profile.sessions[i - 1][0] &&
+                        profile.sessions[i][1] < profile.sessions[i - 1][2]) {
+                        search.orderedTimes = false;
+                    }
+                }
+
+                search.profiles[course].push_back(std::move(profile));
             }
+        }
 
-            if (selection.registrationGroup) {
-                processGroupSessions(selection, selection.registrationGroup, "Registration", daySchedules);
+        for (size_t course = allOptions.size(); course-- > 0;) {
+            search.remainingCoverage[course] = search.remainingCoverage[course + 1];
+            int cheapest = 0;
+            for (size_t option = 0; option < allOptions[course].size(); option++) {
+                search.remainingCoverage[course].merge(allOptions[course][option].occupancy);
+                int classTime = search.profiles[course][option].classTime;
+                cheapest = option == 0 ? classTime : min(cheapest, classTime);
             }
+            search.remainingMinClassTime[course] = search.remainingMinClassTime[course + 1] + cheapest;
+        }
+
+        SearchState state = makeSearchState(allOptions);
+        searchTopK(0, allOptions, state, search);
+
+        Logger::get().logInfo("Top-K search visited " + to_string(search.nodes) + " nodes, pruned " +
+                              to_string(search.pruned));
+
+        vector<TopKEntry> ranked;
+        while (!search.best.empty()) {
+            ranked.push_back(search.best.top());
+            search.best.pop();
+        }
+        reverse(ranked.begin(), ranked.end());
+
+        ScheduleId ids(semester);
+        for (auto& entry : ranked) {
+            InformativeSchedule schedule = std::move(entry.schedule);
+            schedule.index = static_cast<int>(results.size());
+            schedule.unique_id = ids.idOf(schedule.index);
+            schedule.unique_key = ids.keyOf(schedule.index);
+            results.push_back(std::move(schedule));
+        }
+
+    } catch (const std::bad_alloc& e) {
+        Logger::get().logError("Out of memory during top-K search: " + string(e.what()));
+        results.clear();
+    } catch (const exception& e) {
+        Logger::get().logError("Exception in ScheduleBuilder::buildTopK: " + string(e.what()));
+    }
 
-            if (selection.thesisGroup) {
-                processGroupSessions(selection, selection.thesisGroup, "Thesis", daySchedules);
+    return results;
+}
+
+void ScheduleBuilder::searchTopK(size_t depth, const vector<vector<CourseSelection>>& allOptions,
+                                 SearchState& state, TopKSearch& search) {
+    search.nodes++;
+
+    if (constraints.active() && !withinConstraints(state)) {
+        return;
+    }
+
+    if (search.best.size() >= search.k) {
+        // Later leaves lose ties to earlier ones, so an equal bound cannot improve the result either
+        if (lowerBound(search, state.metrics, depth) >= search.best.top().value) {
+            search.pruned++;
+            return;
+        }
+    }
+
+    if (depth == allOptions.size()) {
+        vector<const CourseSelection*> selections;
+        selections.reserve(allOptions.size());
+        for (size_t course = 0; course < allOptions.size(); course++) {
+            selections.push_back(&allOptions[course][state.chosen[course]]);
+        }
+
+        InformativeSchedule schedule = convertToInformativeSchedule(selections, 0, &state.metrics);
+        double value = search.objective->evaluate(schedule);
+
+        if (search.best.size() < search.k) {
+            search.best.push({value, state.chosen, std::move(schedule)});
+        } else if (value < search.best.top().value) {
+            search.best.pop();
+            search.best.push({value, state.chosen, std::move(schedule)});
+        }
+        return;
+    }
+
+    const OptionBitset& candidates = state.candidates[depth][depth];
+
+    for (size_t w = 0; w < candidates.size(); w++) {
+        uint64_t word = candidates[w];
+        while (word) {
+            size_t option = w * 64 + CompatibilityMatrix::lowestBit(word);
+            word &= word - 1;
+
+            if (choose(state, depth, depth, option)) {
+                state.metrics.push(allOptions[depth][option]);
+                searchTopK(depth + 1, allOptions, state, search);
+                state.metrics.pop();
             }
+            state.chosen[depth] = -1;
+        }
+    }
+}
+
+double ScheduleBuilder::lowerBound(const TopKSearch& search, const MetricsAccumulator& metrics, size_t depth) {
+    // Left-out sessions could fill a gap that looks locked, so an overflowing path is never pruned
+    if (metrics.overflowed()) {
+        return -numeric_limits<double>::infinity();
+    }
 
-            if (selection.projectGroup) {
-                processGroupSessions(selection, selection.projectGroup, "Project", daySchedules);
+    int days = 0, longestStreak = 0, streak = 0;
+    int lockedGaps = 0, lockedGapTime = 0, longestLockedGap = 0, maxDailyLockedGaps = 0;
+    int maxDailyHours = 0, earliestStart = INT_MAX, latestEnd = 0;
+
+    for (int day = 1; day <= 7; day++) {
+        const int sessionCount = metrics.count(day);
+        if (sessionCount == 0) {
+            streak = 0;
+            continue;
+        }
+
+        days++;
+        longestStreak = max(longestStreak, ++streak);
+        earliestStart = min(earliestStart, metrics.dayStart(day));
+        latestEnd = max(latestEnd, metrics.dayEnd(day));
+
+        int dailyLockedGaps = 0;
+        for (int i = 0; search.orderedTimes && i + 1 < sessionCount; i++) {
+            const pair<int, int>& current = metrics.session(day, i);
+            const pair<int, int>& next = metrics.session(day, i + 1);
+
+            // A gap stays as it is unless a remaining course can place a session inside it
+            int gap = next.first - current.second;
+            if (gap >= 30 && !search.remainingCoverage[depth].intersectsRange(day, current.second, next.first)) {
+                lockedGaps++;
+                dailyLockedGaps++;
+                lockedGapTime += gap;
+                longestLockedGap = max(longestLockedGap, gap);
             }
         }
+        maxDailyLockedGaps = max(maxDailyLockedGaps, dailyLockedGaps);
+        maxDailyHours = max(maxDailyHours, (metrics.dayClassTime(day) + 30) / 60);
+    }
+
+    double bound = 0.0;
+    for (const auto& term : search.objective->terms) {
+        if (term.weight < 0) {
+            bound += term.weight * ScheduleObjective::metricUpperBound(term.metric);
+            continue;
+        }
 
-        // Build schedule days
-        for (int day = 0; day < 7; day++) {
-            ScheduleDay scheduleDay;
-            scheduleDay.day = dayNames[day];
+        // Metrics that only grow as courses are added are bounded by their current value
+        double metricBound = 0.0;
+        switch (term.metric) {
+            case ScheduleMetric::AMOUNT_DAYS: metricBound = days; break;
+            case ScheduleMetric::CONSECUTIVE_DAYS: metricBound = longestStreak; break;
+            case ScheduleMetric::AMOUNT_GAPS: metricBound = lockedGaps; break;
+            case ScheduleMetric::GAPS_TIME: metricBound = lockedGapTime; break;
+            case ScheduleMetric::LONGEST_GAP: metricBound = longestLockedGap; break;
+            case ScheduleMetric::MAX_DAILY_GAPS: metricBound = maxDailyLockedGaps; break;
+            case ScheduleMetric::MAX_DAILY_HOURS: metricBound = maxDailyHours; break;
+            case ScheduleMetric::LATEST_END:
+                metricBound = search.orderedTimes ? latestEnd : 0;
+                break;
+            case ScheduleMetric::SCHEDULE_SPAN:
+                metricBound = search.orderedTimes && earliestStart != INT_MAX ? latestEnd - earliestStart : 0;
+                break;
+            case ScheduleMetric::TOTAL_CLASS_TIME:
+                metricBound = metrics.classTime() + search.remainingMinClassTime[depth];
+                break;
+            default: break;
+        }
+        bound += term.weight * metricBound;
+    }
+    return bound;
+}
+
+// Schedule counting
+
+uint64_t ScheduleBuilder::countSchedules(const vector<Course>& courses) {
+    uint64_t count = 0;
+
+    try {
+        CourseLegalComb generator;
+        vector<vector<CourseSelection>> allOptions;
+        for (const auto& course : courses) {
+            allOptions.push_back(generator.generate(course));
+        }
+
+        compatibility.build(allOptions);
+
+        SearchState state = makeSearchState(allOptions);
+        CountMemo memo(allOptions.size());
+        count = countFrom(0, state, memo);
+
+        Logger::get().logInfo("Counted " + to_string(count) + " valid schedules for " +
+                              to_string(courses.size()) + " courses");
+    } catch (const std::bad_alloc& e) {
+        Logger::get().logError("Out of memory during schedule counting: " + string(e.what()));
+        count = 0;
+    } catch (const exception& e) {
+        Logger::get().logError("Exception in ScheduleBuilder::countSchedules: " + string(e.what()));
+        count = 0;
+    }
+
+    return count;
+}
+
+uint64_t ScheduleBuilder::countFrom(size_t depth, SearchState& state, CountMemo& memo) const {
+    const size_t courseCount = state.chosen.size();
+    if (depth == courseCount) {
+        return 1;
+    }
+
+    const vector<OptionBitset>& candidates = state.candidates[depth];
+    if (depth + 1 == courseCount) {
+        return CompatibilityMatrix::countOptions(candidates[depth]);
+    }
+
+    vector<uint64_t> key;
+    for (size_t course = depth; course < courseCount; course++) {
+        bool any = false;
+        for (uint64_t word : candidates[course]) {
+            any = any || word != 0;
+        }
+        if (!any) return 0;
+        key.insert(key.end(), candidates[course].begin(), candidates[course].end());
+    }
 
-            auto it = daySchedules.find(day +1);
-            if (it != daySchedules.end()) {
-                scheduleDay.day_items = it->second;
-                sort(scheduleDay.day_items.begin(), scheduleDay.day_items.end(),
-                     [](const ScheduleItem& a, const ScheduleItem& b) {
-                         return a.start < b.start;
-                     });
+    auto cached = memo[depth].find(key);
+    if (cached != memo[depth].end()) {
+        return cached->second;
+    }
+
+    uint64_t total = 0;
+    for (size_t w = 0; w < candidates[depth].size(); w++) {
+        uint64_t word = candidates[depth][w];
+        while (word) {
+            size_t option = w * 64 + CompatibilityMatrix::lowestBit(word);
+            word &= word - 1;
+
+            if (choose(state, depth, depth, option)) {
+                total += countFrom(depth + 1, state, memo);
             }
+            state.chosen[depth] = -1;
+        }
+    }
 
-            schedule.week.push_back(scheduleDay);
+    if (memo[depth].size() < MAX_COUNT_MEMO_ENTRIES) {
+        memo[depth].emplace(std::move(key), total);
+    }
+    return total;
+}
+
+// Course metadata
+
+void ScheduleBuilder::prepareGeneration(const vector<Course>& courses, const string& semester) {
+    currentSemester = semester;
+    courseInfos.clear();
+    courseInfos.reserve(courses.size());
+    for (const auto& course : courses) {
+        courseInfos.emplace_back(course);
+    }
+}
+
+// Convert to informative schedule and calculate metadata
+
+InformativeSchedule ScheduleBuilder::convertToInformativeSchedule(const vector<const CourseSelection*>& selections, int index,
+                                                                  const MetricsAccumulator* metrics,
+                                                                  bool withWeek) const {
+    InformativeSchedule schedule;
+    schedule.index = index;
+    schedule.semester = currentSemester;
+
+    try {
+        if (withWeek) {
+            schedule.week = buildWeek(selections, courseInfos);
         }
 
-        calculateScheduleMetrics(schedule);
+        // Metrics come from the pre-parsed session times, not from the week's strings. A day with
+        // more sessions than the accumulator holds is sorted in full instead.
+        if (metrics && !metrics->overflowed()) {
+            calculateScheduleMetrics(schedule, *metrics);
+        } else {
+            calculateScheduleMetrics(schedule, selections);
+        }
 
     } catch (const exception& e) {
         Logger::get().logError("Exception in convertToInformativeSchedule: " + string(e.what()));
@@ -239,38 +1339,97 @@ InformativeSchedule ScheduleBuilder::convertToInformativeSchedule(const vector<C
         // Create empty schedule on error
         schedule.week.clear();
         const vector<string> dayNames = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
-        for (int day = 0; day < 7; day++) {
+        for (int day = 0; day < 7 && withWeek; day++) {
             ScheduleDay scheduleDay;
             scheduleDay.day = dayNames[day];
             schedule.week.push_back(scheduleDay);
         }
 
-        calculateScheduleMetrics(schedule);
+        calculateScheduleMetrics(schedule, vector<const CourseSelection*>());
     }
 
     return schedule;
 }
 
-void ScheduleBuilder::processGroupSessions(const CourseSelection& selection, const Group* group,
-                                           const string& sessionType, map<int, vector<ScheduleItem>>& daySchedules) {
+vector<ScheduleDay> ScheduleBuilder::buildWeek(const vector<const CourseSelection*>& selections,
+                                               const vector<CourseInfo>& courseInfos) {
+    const vector<string> dayNames = {"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+
+    // Items of each day (index 1-7) keyed by their start minutes
+    array<vector<pair<int, ScheduleItem>>, 8> daySchedules;
+
+    static const CourseInfo unknownCourse("Unknown ID", "Unknown Course");
+    static const array<InternedString, GROUP_TYPE_SLOTS.size()> labels = []() {
+        array<InternedString, GROUP_TYPE_SLOTS.size()> result;
+        for (size_t i = 0; i < GROUP_TYPE_SLOTS.size(); i++) {
+            result[i] = GROUP_TYPE_SLOTS[i].label;
+        }
+        return result;
+    }();
+
+    for (size_t course = 0; course < selections.size(); course++) {
+        const CourseInfo& info = course < courseInfos.size() ? courseInfos[course] : unknownCourse;
+
+        for (size_t i = 0; i < GROUP_TYPE_SLOTS.size(); i++) {
+            processGroupSessions(info, selections[course]->groups[GROUP_TYPE_SLOTS[i].slot], labels[i], daySchedules);
+        }
+    }
+
+    // Build schedule days
+    vector<ScheduleDay> week(7);
+    for (int day = 0; day < 7; day++) {
+        week[day].day = dayNames[day];
+
+        auto& items = daySchedules[day + 1];
+        stable_sort(items.begin(), items.end(), [](const pair<int, ScheduleItem>& a, const pair<int, ScheduleItem>& b) {
+            return a.first < b.first;
+        });
+
+        week[day].day_items.reserve(items.size());
+        for (auto& item : items) {
+            week[day].day_items.push_back(std::move(item.second));
+        }
+    }
+
+    return week;
+}
+
+void ScheduleBuilder::processGroupSessions(const CourseInfo& courseInfo, const Group* group,
+                                           const InternedString& sessionType,
+                                           array<vector<pair<int, ScheduleItem>>, 8>& daySchedules) {
     if (!group) return;
 
     try {
-        string courseName = getCourseNameById(selection.courseId);
-        string courseRawId = getCourseRawIdById(selection.courseId);
-
         for (const auto& session : group->sessions) {
+            if (session.day_of_week < 1 || session.day_of_week > 7) continue;
+
+            // Times that do not parse go to the end of the day
+            int start;
+            try {
+                start = TimeUtils::startMinutes(session);
+            } catch (const exception&) {
+                start = INT_MAX;
+            }
 
             ScheduleItem item;
-            item.courseName = courseName;
-            item.raw_id = courseRawId;
+            item.courseName = courseInfo.name;
+            item.raw_id = courseInfo.raw_id;
             item.type = sessionType;
-            item.start = session.start_time;
-            item.end = session.end_time;
-            item.building = session.building_number;
-            item.room = session.room_number;
 
-            daySchedules[session.day_of_week].push_back(item);
+            auto strings = courseInfo.sessions.find(&session);
+            if (strings != courseInfo.sessions.end()) {
+                item.start = strings->second.start;
+                item.end = strings->second.end;
+                item.building = strings->second.building;
+                item.room = strings->second.room;
+            } else {
+                item.start = session.start_time;
+                item.end = session.end_time;
+                item.building = session.building_number;
+                item.room = session.room_number;
+            }
+
+            daySchedules[session.day_of_week].emplace_back(start, std::move(item));
         }
 
     } catch (const exception& e) {
@@ -278,88 +1437,112 @@ void ScheduleBuilder::processGroupSessions(const CourseSelection& selection, con
     }
 }
 
-void ScheduleBuilder::calculateScheduleMetrics(InformativeSchedule& schedule) {
-    // Initialize all metrics
-    int totalDaysWithItems = 0;
-    int totalGaps = 0;
-    int totalGapTime = 0;
-    int totalStartTime = 0;
-    int totalEndTime = 0;
-
-    // NEW: Enhanced metrics
-    int earliestStart = INT_MAX;
-    int latestEnd = 0;
-    int longestGap = 0;
-    int totalClassTime = 0;
-    int consecutiveDays = 0;
-    int maxDailyHours = 0;
-    int minDailyHours = INT_MAX;
-    int totalDailyHours = 0;
-    int maxDailyGaps = 0;
-    int totalGapsForAvg = 0;
-    int gapCount = 0;
-    int scheduleSpan = 0;
-
-    // Boolean flags
-    bool hasEarlyMorning = false;
-    bool hasMorning = false;
-    bool hasEvening = false;
-    bool hasLateEvening = false;
-    bool hasLunchBreak = false;
-    bool weekendClasses = false;
-
-    // Day tracking
-    std::vector<int> daysWithClasses;
-    std::vector<bool> dayHasClasses(8, false);
-
-    try {
-        for (int dayIndex = 0; dayIndex < static_cast<int>(schedule.week.size()); dayIndex++) {
-            const auto& scheduleDay = schedule.week[dayIndex];
-
-            if (scheduleDay.day_items.empty()) {
-                continue;
+namespace {
+
+    // Unbounded per-day session lists, for schedules with more sessions on a day than a
+    // MetricsAccumulator holds
+    class SessionLists {
+    public:
+        explicit SessionLists(const vector<const CourseSelection*>& selections) {
+            for (const CourseSelection* selection : selections) {
+                for (const SessionTime& time : selection->sessionTimes) {
+                    if (time.day < 1 || time.day > 7) continue;
+                    days[time.day].emplace_back(time.start, time.end);
+                    classTimes[time.day] += time.end - time.start;
+                }
+            }
+            for (auto& sessions : days) {
+                sort(sessions.begin(), sessions.end());
             }
+        }
 
-            totalDaysWithItems++;
-            int algorithmDay = dayIndex + 1;
-            daysWithClasses.push_back(algorithmDay);
-            dayHasClasses[algorithmDay] = true;
+        int count(int day) const { return static_cast<int>(days[day].size()); }
+        const pair<int, int>& session(int day, int i) const { return days[day][i]; }
+        int dayStart(int day) const { return days[day].front().first; }
+        int dayEnd(int day) const { return days[day].back().second; }
+        int dayClassTime(int day) const { return classTimes[day]; }
+
+    private:
+        array<vector<pair<int, int>>, 8> days;
+        array<int, 8> classTimes{};
+    };
+
+    // Fills the metrics from per-day sorted sessions (MetricsAccumulator or SessionLists). Start,
+    // end and class time of each day come with the sessions; only the gaps are derived here.
+    template <typename SessionDays>
+    void fillScheduleMetrics(InformativeSchedule& schedule, const SessionDays& metrics) {
+        // Initialize all metrics
+        int totalDaysWithItems = 0;
+        int totalGaps = 0;
+        int totalGapTime = 0;
+        int totalStartTime = 0;
+        int totalEndTime = 0;
+
+        int earliestStart = INT_MAX;
+        int latestEnd = 0;
+        int longestGap = 0;
+        int totalClassTime = 0;
+        int consecutiveDays = 0;
+        int maxDailyHours = 0;
+        int minDailyHours = INT_MAX;
+        int totalDailyHours = 0;
+        int maxDailyGaps = 0;
+        int totalGapsForAvg = 0;
+        int gapCount = 0;
+        int scheduleSpan = 0;
 
-            // Check for weekend classes (Saturday=7, Sunday=1)
-            if (algorithmDay == 1 || algorithmDay == 7) {
-                weekendClasses = true;
-            }
+        // Boolean flags
+        bool hasEarlyMorning = false;
+        bool hasMorning = false;
+        bool hasEvening = false;
+        bool hasLateEvening = false;
+        bool hasLunchBreak = false;
+        bool weekendClasses = false;
 
-            // Daily calculations
-            int dayStartMinutes = TimeUtils::toMinutes(scheduleDay.day_items.front().start);
-            int dayEndMinutes = TimeUtils::toMinutes(scheduleDay.day_items.back().end);
-            int dailyClassTime = 0;
-            int dailyGaps = 0;
+        // Day tracking
+        std::vector<int> daysWithClasses;
+        std::vector<bool> dayHasClasses(8, false);
 
-            // Update global earliest/latest
-            earliestStart = std::min(earliestStart, dayStartMinutes);
-            latestEnd = std::max(latestEnd, dayEndMinutes);
+        try {
+            for (int algorithmDay = 1; algorithmDay <= 7; algorithmDay++) {
+                const int sessionCount = metrics.count(algorithmDay);
 
-            totalStartTime += dayStartMinutes;
-            totalEndTime += dayEndMinutes;
+                if (sessionCount == 0) {
+                    continue;
+                }
 
-            // Check time preferences
-            if (dayStartMinutes < 510) hasEarlyMorning = true;  // Before 8:30 AM
-            if (dayStartMinutes < 600) hasMorning = true;       // Before 10:00 AM
-            if (dayEndMinutes > 1080) hasEvening = true;        // After 6:00 PM
-            if (dayEndMinutes > 1200) hasLateEvening = true;    // After 8:00 PM
+                totalDaysWithItems++;
+                daysWithClasses.push_back(algorithmDay);
+                dayHasClasses[algorithmDay] = true;
 
-            // Calculate daily class time and gaps
-            for (size_t i = 0; i < scheduleDay.day_items.size(); i++) {
-                const auto& item = scheduleDay.day_items[i];
-                int itemStart = TimeUtils::toMinutes(item.start);
-                int itemEnd = TimeUtils::toMinutes(item.end);
-                dailyClassTime += (itemEnd - itemStart);
+                // Check for weekend classes (Saturday=7, Sunday=1)
+                if (algorithmDay == 1 || algorithmDay == 7) {
+                    weekendClasses = true;
+                }
 
-                // Check for gaps
-                if (i < scheduleDay.day_items.size() - 1) {
-                    int currentEndMinutes = itemEnd;
-                    int nextStartMinutes = TimeUtils::toMinutes(scheduleDay.day_items[i + 1].start);
+                // Daily calculations
+                int dayStartMinutes = metrics.dayStart(algorithmDay);
+                int dayEndMinutes = metrics.dayEnd(algorithmDay);
+                int dailyClassTime = metrics.dayClassTime(algorithmDay);
+                int dailyGaps = 0;
+
+                // Update global earliest/latest
+                earliestStart = std::min(earliestStart, dayStartMinutes);
+                latestEnd = std::max(latestEnd, dayEndMinutes);
+
+                totalStartTime += dayStartMinutes;
+                totalEndTime += dayEndMinutes;
+
+                // Check time preferences
+                if (dayStartMinutes < 510) hasEarlyMorning = true;  // Before 8:30 AM
+                if (dayStartMinutes < 600) hasMorning = true;       // Before 10:00 AM
+                if (dayEndMinutes > 1080) hasEvening = true;        // After 6:00 PM
+                if (dayEndMinutes > 1200) hasLateEvening = true;    // After 8:00 PM
+
+                // Calculate gaps between consecutive sessions
+                for (int i = 0; i + 1 < sessionCount; i++) {
+                    int currentEndMinutes = metrics.session(algorithmDay, i).second;
+                    int nextStartMinutes = metrics.session(algorithmDay, i + 1).first;
                     int gapDuration = nextStartMinutes - currentEndMinutes;
 
                     if (gapDuration >= 30) {  // 30+ minute gap
@@ -376,148 +1559,142 @@ void ScheduleBuilder::calculateScheduleMetrics(InformativeSchedule& schedule) {
                         }
                     }
                 }
-            }
 
-            totalClassTime += dailyClassTime;
-            maxDailyGaps = std::max(maxDailyGaps, dailyGaps);
+                totalClassTime += dailyClassTime;
+                maxDailyGaps = std::max(maxDailyGaps, dailyGaps);
 
-            // Daily hours calculation (convert minutes to hours, rounded)
-            int dailyHours = (dailyClassTime + 30) / 60; // Round to nearest hour
-            maxDailyHours = std::max(maxDailyHours, dailyHours);
-            if (totalDaysWithItems == 1) {
-                minDailyHours = dailyHours;
-            } else {
-                minDailyHours = std::min(minDailyHours, dailyHours);
+                // Daily hours calculation (convert minutes to hours, rounded)
+                int dailyHours = (dailyClassTime + 30) / 60; // Round to nearest hour
+                maxDailyHours = std::max(maxDailyHours, dailyHours);
+                if (totalDaysWithItems == 1) {
+                    minDailyHours = dailyHours;
+                } else {
+                    minDailyHours = std::min(minDailyHours, dailyHours);
+                }
+                totalDailyHours += dailyHours;
             }
-            totalDailyHours += dailyHours;
-        }
 
-        // Calculate consecutive days
-        if (!daysWithClasses.empty()) {
-            std::sort(daysWithClasses.begin(), daysWithClasses.end());
-            int currentStreak = 1;
-            int maxStreak = 1;
-
-            for (size_t i = 1; i < daysWithClasses.size(); i++) {
-                if (daysWithClasses[i] == daysWithClasses[i-1] + 1) {
-                    currentStreak++;
-                    maxStreak = std::max(maxStreak, currentStreak);
-                } else {
-                    currentStreak = 1;
+            // Calculate consecutive days
+            if (!daysWithClasses.empty()) {
+                std::sort(daysWithClasses.begin(), daysWithClasses.end());
+                int currentStreak = 1;
+                int maxStreak = 1;
+
+                for (size_t i = 1; i < daysWithClasses.size(); i++) {
+                    if (daysWithClasses[i] == daysWithClasses[i-1] + 1) {
+                        currentStreak++;
+                        maxStreak = std::max(maxStreak, currentStreak);
+                    } else {
+                        currentStreak = 1;
+                    }
                 }
+                consecutiveDays = maxStreak;
             }
-            consecutiveDays = maxStreak;
-        }
 
-        // Calculate schedule span and compactness
-        if (earliestStart != INT_MAX && latestEnd > 0) {
-            scheduleSpan = latestEnd - earliestStart;
-        }
+            // Calculate schedule span and compactness
+            if (earliestStart != INT_MAX && latestEnd > 0) {
+                scheduleSpan = latestEnd - earliestStart;
+            }
 
-        // Set basic metrics
-        schedule.amount_days = totalDaysWithItems;
-        schedule.amount_gaps = totalGaps;
-        schedule.gaps_time = totalGapTime;
+            // Set basic metrics
+            schedule.amount_days = totalDaysWithItems;
+            schedule.amount_gaps = totalGaps;
+            schedule.gaps_time = totalGapTime;
 
-        // Calculate averages
-        if (totalDaysWithItems > 0) {
-            schedule.avg_start = totalStartTime / totalDaysWithItems;
-            schedule.avg_end = totalEndTime / totalDaysWithItems;
-        } else {
+            // Calculate averages
+            if (totalDaysWithItems > 0) {
+                schedule.avg_start = totalStartTime / totalDaysWithItems;
+                schedule.avg_end = totalEndTime / totalDaysWithItems;
+            } else {
+                schedule.avg_start = 0;
+                schedule.avg_end = 0;
+            }
+
+            // Set enhanced metrics
+            schedule.earliest_start = (earliestStart == INT_MAX) ? 0 : earliestStart;
+            schedule.latest_end = latestEnd;
+            schedule.longest_gap = longestGap;
+            schedule.total_class_time = totalClassTime;
+            schedule.consecutive_days = consecutiveDays;
+            schedule.max_daily_hours = maxDailyHours;
+            schedule.min_daily_hours = (minDailyHours == INT_MAX) ? 0 : minDailyHours;
+            schedule.avg_daily_hours = totalDaysWithItems > 0 ? totalDailyHours / totalDaysWithItems : 0;
+            schedule.max_daily_gaps = maxDailyGaps;
+            schedule.avg_gap_length = gapCount > 0 ? totalGapsForAvg / gapCount : 0;
+            schedule.schedule_span = scheduleSpan;
+            schedule.compactness_ratio = scheduleSpan > 0 ? static_cast<double>(totalClassTime) / scheduleSpan : 0.0;
+
+            // Boolean flags
+            schedule.has_early_morning = hasEarlyMorning;
+            schedule.has_morning_classes = hasMorning;
+            schedule.has_evening_classes = hasEvening;
+            schedule.has_late_evening = hasLateEvening;
+            schedule.has_lunch_break = hasLunchBreak;
+            schedule.weekend_classes = weekendClasses;
+            schedule.weekday_only = !weekendClasses && totalDaysWithItems > 0;
+
+            // Individual day flags
+            schedule.has_sunday = dayHasClasses[1];
+            schedule.has_monday = dayHasClasses[2];
+            schedule.has_tuesday = dayHasClasses[3];
+            schedule.has_wednesday = dayHasClasses[4];
+            schedule.has_thursday = dayHasClasses[5];
+            schedule.has_friday = dayHasClasses[6];
+            schedule.has_saturday = dayHasClasses[7];
+
+            // Days JSON array
+            schedule.days_json = "[";
+            for (size_t i = 0; i < daysWithClasses.size(); i++) {
+                if (i > 0) schedule.days_json += ",";
+                schedule.days_json += std::to_string(daysWithClasses[i]);
+            }
+            schedule.days_json += "]";
+
+        } catch (const exception& e) {
+            Logger::get().logError("Exception in enhanced calculateScheduleMetrics: " + string(e.what()));
+            // Set safe defaults on error
+            schedule.amount_days = 0;
+            schedule.amount_gaps = 0;
+            schedule.gaps_time = 0;
             schedule.avg_start = 0;
             schedule.avg_end = 0;
+            // Set all new fields to safe defaults
+            schedule.earliest_start = 0;
+            schedule.latest_end = 0;
+            schedule.longest_gap = 0;
+            schedule.total_class_time = 0;
+            schedule.consecutive_days = 0;
+            schedule.max_daily_hours = 0;
+            schedule.min_daily_hours = 0;
+            schedule.avg_daily_hours = 0;
+            schedule.max_daily_gaps = 0;
+            schedule.avg_gap_length = 0;
+            schedule.schedule_span = 0;
+            schedule.compactness_ratio = 0.0;
+            schedule.has_early_morning = false;
+            schedule.has_morning_classes = false;
+            schedule.has_evening_classes = false;
+            schedule.has_late_evening = false;
+            schedule.has_lunch_break = false;
+            schedule.weekend_classes = false;
+            schedule.weekday_only = false;
+            schedule.has_monday = false;
+            schedule.has_tuesday = false;
+            schedule.has_wednesday = false;
+            schedule.has_thursday = false;
+            schedule.has_friday = false;
+            schedule.has_saturday = false;
+            schedule.has_sunday = false;
+            schedule.days_json = "[]";
         }
+    }
+}
 
-        // NEW: Set enhanced metrics
-        schedule.earliest_start = (earliestStart == INT_MAX) ? 0 : earliestStart;
-        schedule.latest_end = latestEnd;
-        schedule.longest_gap = longestGap;
-        schedule.total_class_time = totalClassTime;
-        schedule.consecutive_days = consecutiveDays;
-        schedule.max_daily_hours = maxDailyHours;
-        schedule.min_daily_hours = (minDailyHours == INT_MAX) ? 0 : minDailyHours;
-        schedule.avg_daily_hours = totalDaysWithItems > 0 ? totalDailyHours / totalDaysWithItems : 0;
-        schedule.max_daily_gaps = maxDailyGaps;
-        schedule.avg_gap_length = gapCount > 0 ? totalGapsForAvg / gapCount : 0;
-        schedule.schedule_span = scheduleSpan;
-        schedule.compactness_ratio = scheduleSpan > 0 ? static_cast<double>(totalClassTime) / scheduleSpan : 0.0;
-
-        // Boolean flags
-        schedule.has_early_morning = hasEarlyMorning;
-        schedule.has_morning_classes = hasMorning;
-        schedule.has_evening_classes = hasEvening;
-        schedule.has_late_evening = hasLateEvening;
-        schedule.has_lunch_break = hasLunchBreak;
-        schedule.weekend_classes = weekendClasses;
-        schedule.weekday_only = !weekendClasses && totalDaysWithItems > 0;
-
-        // Individual day flags
-        schedule.has_sunday = dayHasClasses[1];
-        schedule.has_monday = dayHasClasses[2];
-        schedule.has_tuesday = dayHasClasses[3];
-        schedule.has_wednesday = dayHasClasses[4];
-        schedule.has_thursday = dayHasClasses[5];
-        schedule.has_friday = dayHasClasses[6];
-        schedule.has_saturday = dayHasClasses[7];
-
-        // Days JSON array
-        schedule.days_json = "[";
-        for (size_t i = 0; i < daysWithClasses.size(); i++) {
-            if (i > 0) schedule.days_json += ",";
-            schedule.days_json += std::to_string(daysWithClasses[i]);
-        }
-        schedule.days_json += "]";
+void ScheduleBuilder::calculateScheduleMetrics(InformativeSchedule& schedule, const MetricsAccumulator& metrics) {
+    fillScheduleMetrics(schedule, metrics);
+}
 
-    } catch (const exception& e) {
-        Logger::get().logError("Exception in enhanced calculateScheduleMetrics: " + string(e.what()));
-        // Set safe defaults on error
-        schedule.amount_days = 0;
-        schedule.amount_gaps = 0;
-        schedule.gaps_time = 0;
-        schedule.avg_start = 0;
-        schedule.avg_end = 0;
-        // Set all new fields to safe defaults
-        schedule.earliest_start = 0;
-        schedule.latest_end = 0;
-        schedule.longest_gap = 0;
-        schedule.total_class_time = 0;
-        schedule.consecutive_days = 0;
-        schedule.max_daily_hours = 0;
-        schedule.min_daily_hours = 0;
-        schedule.avg_daily_hours = 0;
-        schedule.max_daily_gaps = 0;
-        schedule.avg_gap_length = 0;
-        schedule.schedule_span = 0;
-        schedule.compactness_ratio = 0.0;
-        schedule.has_early_morning = false;
-        schedule.has_morning_classes = false;
-        schedule.has_evening_classes = false;
-        schedule.has_late_evening = false;
-        schedule.has_lunch_break = false;
-        schedule.weekend_classes = false;
-        schedule.weekday_only = false;
-        schedule.has_monday = false;
-        schedule.has_tuesday = false;
-        schedule.has_wednesday = false;
-        schedule.has_thursday = false;
-        schedule.has_friday = false;
-        schedule.has_saturday = false;
-        schedule.has_sunday = false;
-        schedule.days_json = "[]";
-    }
-}
-
-string ScheduleBuilder::generateUniqueScheduleId(const string& semester, int index) {
-    // Simple approach: semester + timestamp + index + random component
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1000, 9999);
-    int randomComponent = dis(gen);
-
-    std::stringstream ss;
-    ss << semester << "_" << timestamp << "_" << index << "_" << randomComponent;
-    return ss.str();
+void ScheduleBuilder::calculateScheduleMetrics(InformativeSchedule& schedule,
+                                               const vector<const CourseSelection*>& selections) {
+    fillScheduleMetrics(schedule, SessionLists(selections));
 }
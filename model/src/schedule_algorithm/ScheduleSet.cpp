@@ -0,0 +1,140 @@
+#include "ScheduleSet.h"
+#include "ScheduleBuilder.h"
+#include "TimeUtils.h"
+
+#include <algorithm>
+#include <climits>
+
+ScheduleSet::ScheduleSet(const vector<Course>& courses) : courses(courses) {
+    // Built from the set's own copy, whose sessions the options point into
+    courseInfo.reserve(this->courses.size());
+    for (const auto& course : this->courses) {
+        courseInfo.emplace_back(course);
+    }
+}
+
+ScheduleSet::ScheduleSet(size_t courseCount, map<uint64_t, vector<ScheduleDay>> optionWeeks)
+        : options(courseCount), stored(true), storedWeeks(std::move(optionWeeks)) {}
+
+bool ScheduleSet::appendStored(const vector<uint32_t>& tuple, size_t& position) {
+    if (!stored || tuple.size() != options.size()) {
+        return false;
+    }
+    for (size_t course = 0; course < tuple.size(); course++) {
+        if (!storedWeeks.count((uint64_t(course) << 32) | tuple[course])) {
+            return false;
+        }
+    }
+
+    lock_guard<mutex> lock(tuplesMutex);
+    tuples.insert(tuples.end(), tuple.begin(), tuple.end());
+    position = scheduleCount++;
+    return true;
+}
+
+size_t ScheduleSet::append(const vector<int>& tuple) {
+    lock_guard<mutex> lock(tuplesMutex);
+    for (int option : tuple) {
+        tuples.push_back(static_cast<uint32_t>(option));
+    }
+    return scheduleCount++;
+}
+
+vector<ScheduleDay> ScheduleSet::expandWeek(size_t position) const {
+    if (stored) {
+        vector<uint32_t> tuple = tupleOf(position);
+        vector<const vector<ScheduleDay>*> parts;
+        parts.reserve(tuple.size());
+        for (size_t course = 0; course < tuple.size(); course++) {
+            parts.push_back(&storedWeeks.at((uint64_t(course) << 32) | tuple[course]));
+        }
+        return joinOptionWeeks(parts);
+    }
+
+    vector<const CourseSelection*> selections;
+    selections.reserve(options.size());
+
+    {
+        lock_guard<mutex> lock(tuplesMutex);
+        const uint32_t* tuple = tuples.data() + position * options.size();
+        for (size_t course = 0; course < options.size(); course++) {
+            selections.push_back(&options[course][tuple[course]]);
+        }
+    }
+
+    return ScheduleBuilder::buildWeek(selections, courseInfo);
+}
+
+vector<ScheduleDay> ScheduleSet::weekOf(const InformativeSchedule& schedule) {
+    if (!schedule.week.empty() || !schedule.source || schedule.source_position >= schedule.source->size()) {
+        return schedule.week;
+    }
+
+    try {
+        return schedule.source->expandWeek(schedule.source_position);
+    } catch (const exception& e) {
+        Logger::get().logError("Exception expanding schedule " + to_string(schedule.index) + ": " + string(e.what()));
+        return {};
+    }
+}
+
+InformativeSchedule ScheduleSet::expanded(const InformativeSchedule& schedule) {
+    InformativeSchedule result = schedule;
+    if (result.week.empty()) {
+        result.week = weekOf(schedule);
+    }
+    return result;
+}
+
+vector<uint32_t> ScheduleSet::tupleOf(size_t position) const {
+    lock_guard<mutex> lock(tuplesMutex);
+    const uint32_t* tuple = tuples.data() + position * options.size();
+    return vector<uint32_t>(tuple, tuple + options.size());
+}
+
+vector<ScheduleDay> ScheduleSet::optionWeek(size_t course, uint32_t option) const {
+    if (stored) {
+        return storedWeeks.at((uint64_t(course) << 32) | option);
+    }
+    return ScheduleBuilder::buildWeek({&options[course][option]}, {courseInfo[course]});
+}
+
+vector<ScheduleDay> ScheduleSet::joinOptionWeeks(const vector<const vector<ScheduleDay>*>& optionWeeks) {
+    vector<ScheduleDay> week;
+
+    for (const auto* optionWeek : optionWeeks) {
+        if (week.size() < optionWeek->size()) {
+            week.resize(optionWeek->size());
+        }
+        for (size_t day = 0; day < optionWeek->size(); day++) {
+            week[day].day = (*optionWeek)[day].day;
+            const auto& items = (*optionWeek)[day].day_items;
+            week[day].day_items.insert(week[day].day_items.end(), items.begin(), items.end());
+        }
+    }
+
+    // Same order as buildWeek: by start time, ties in course order; unparsable times go last
+    for (auto& day : week) {
+        vector<pair<int, ScheduleItem>> items;
+        items.reserve(day.day_items.size());
+        for (auto& item : day.day_items) {
+            int start;
+            try {
+                start = TimeUtils::toMinutes(item.start);
+            } catch (const exception&) {
+                start = INT_MAX;
+            }
+            items.emplace_back(start, std::move(item));
+        }
+
+        stable_sort(items.begin(), items.end(), [](const pair<int, ScheduleItem>& a, const pair<int, ScheduleItem>& b) {
+            return a.first < b.first;
+        });
+
+        for (size_t i = 0; i < items.size(); i++) {
+            day.day_items[i] = std::move(items[i].second);
+        }
+    }
+
+    return week;
+}
@@ -50,11 +50,11 @@ bool TimeUtils::isOverlap(const Session* s1, const Session* s2) {
         // Sessions on different days cannot overlap
         if (s1->day_of_week != s2->day_of_week) return false;
 
-        // Convert start and end times to minutes
-        int start1 = toMinutes(s1->start_time);
-        int end1 = toMinutes(s1->end_time);
-        int start2 = toMinutes(s2->start_time);
-        int end2 = toMinutes(s2->end_time);
+        // Use the pre-parsed minutes (string parsing only for uncompiled sessions)
+        int start1 = startMinutes(*s1);
+        int end1 = endMinutes(*s1);
+        int start2 = startMinutes(*s2);
+        int end2 = endMinutes(*s2);
 
         // Return true if the time intervals overlap
         return (start1 < end2 && start2 < end1);
@@ -63,4 +63,30 @@ bool TimeUtils::isOverlap(const Session* s1, const Session* s2) {
         Logger::get().logError("isOverlap() error comparing sessions: " + string(e.what()));
         return false;
     }
+}
+
+// Parses the session's time strings once and caches them as minutes since midnight
+bool TimeUtils::compileSession(Session& session) {
+    try {
+        session.start_minutes = toMinutes(session.start_time);
+        session.end_minutes = toMinutes(session.end_time);
+        return true;
+    } catch (const std::exception&) {
+        session.start_minutes = -1;
+        session.end_minutes = -1;
+        return false;
+    }
+}
+
+// Compiles every session of every group type in the course
+void TimeUtils::compileCourse(Course& course) {
+    for (auto* groups : {&course.Lectures, &course.DepartmentalSessions, &course.Reinforcements,
+                         &course.Guidance, &course.OptionalColloquium, &course.Registration,
+                         &course.Thesis, &course.Project, &course.Tirgulim, &course.labs, &course.blocks}) {
+        for (auto& group : *groups) {
+            for (auto& session : group.sessions) {
+                compileSession(session);
+            }
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "WorkStealingPool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+        : threadCount(threadCount > 0 ? threadCount : 1) {}
+
+unsigned WorkStealingPool::defaultThreadCount() {
+    unsigned hardwareThreads = thread::hardware_concurrency();
+    return hardwareThreads > 0 ? hardwareThreads : 1;
+}
+
+void WorkStealingPool::run(const vector<function<void()>>& tasks) {
+    if (tasks.empty()) return;
+
+    unsigned workers = min<unsigned>(threadCount, static_cast<unsigned>(tasks.size()));
+
+    // Deal tasks round-robin so the workers advance through the batch together
+    vector<unique_ptr<WorkerQueue>> queues;
+    for (unsigned w = 0; w < workers; w++) {
+        queues.push_back(make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < tasks.size(); i++) {
+        queues[i % workers]->taskIndices.push_back(i);
+    }
+
+    if (workers == 1) {
+        workerLoop(queues, 0, tasks);
+        return;
+    }
+
+    vector<thread> threads;
+    threads.reserve(workers - 1);
+    for (unsigned w = 1; w < workers; w++) {
+        threads.emplace_back(workerLoop, std::ref(queues), w, std::cref(tasks));
+    }
+
+    // The calling thread works as worker 0
+    workerLoop(queues, 0, tasks);
+
+    for (auto& t : threads) {
+        t.join();
+    }
+}
+
+bool WorkStealingPool::popLocal(WorkerQueue& queue, size_t& taskIndex) {
+    lock_guard<mutex> lock(queue.queueMutex);
+    if (queue.taskIndices.empty()) return false;
+    taskIndex = queue.taskIndices.front();
+    queue.taskIndices.pop_front();
+    return true;
+}
+
+bool WorkStealingPool::steal(vector<unique_ptr<WorkerQueue>>& queues, unsigned thief, size_t& taskIndex) {
+    for (size_t offset = 1; offset < queues.size(); offset++) {
+        WorkerQueue& victim = *queues[(thief + offset) % queues.size()];
+        lock_guard<mutex> lock(victim.queueMutex);
+        if (!victim.taskIndices.empty()) {
+            taskIndex = victim.taskIndices.front();
+            victim.taskIndices.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(vector<unique_ptr<WorkerQueue>>& queues, unsigned workerId,
+                                  const vector<function<void()>>& tasks) {
+    size_t taskIndex;
+
+    // Tasks never enqueue new work, so once every queue is empty the worker is done
+    while (popLocal(*queues[workerId], taskIndex) || steal(queues, workerId, taskIndex)) {
+        try {
+            tasks[taskIndex]();
+        } catch (const exception& e) {
+            Logger::get().logError("Exception in WorkStealingPool task: " + string(e.what()));
+        }
+    }
+}
@@ -1,12 +1,18 @@
 #ifndef MODEL_INTERFACES_H
 #define MODEL_INTERFACES_H
 
+#include "interned_string.h"
+
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 using namespace std;
 
+class ScheduleSet;
+
 
 // Course structs
 
@@ -33,6 +39,10 @@ public:
     string end_time;
     string building_number;
     string room_number;
+
+    // Pre-parsed minutes since midnight, filled once at parse time (-1 until compiled)
+    int start_minutes = -1;
+    int end_minutes = -1;
 };
 
 class Group {
@@ -84,14 +94,15 @@ public:
 
 // Schedule structs
 
+// Item fields are pooled handles; they read like const strings and are assigned from strings
 struct ScheduleItem {
-    string courseName;
-    string raw_id;
-    string type;
-    string start;
-    string end;
-    string building;
-    string room;
+    InternedString courseName;
+    InternedString raw_id;
+    InternedString type;
+    InternedString start;
+    InternedString end;
+    InternedString building;
+    InternedString room;
 };
 
 struct ScheduleDay {
@@ -102,6 +113,7 @@ struct ScheduleDay {
 struct InformativeSchedule {
     int index;
     string unique_id;
+    uint64_t unique_key = 0;  // integer form of unique_id (see ScheduleId)
     string semester = "A";
 
     // Basic metrics
@@ -153,6 +165,37 @@ struct InformativeSchedule {
     bool has_sunday = false;
 
     vector<ScheduleDay> week;
+
+    // Compactly generated schedules leave week empty; it is expanded on demand from the option
+    // tuple stored at source_position in the generating set (see ScheduleSet::weekOf)
+    shared_ptr<const ScheduleSet> source;
+    size_t source_position = 0;
+};
+
+// Limits the generator enforces while searching, so schedules outside them are never built.
+// Negative values and an empty forbiddenDays leave a limit unset.
+struct ScheduleConstraints {
+    int maxDays = -1;
+    int maxGaps = -1;           // gaps of 30+ minutes, as counted in amount_gaps
+    int maxGapTime = -1;        // longest single gap in minutes, as in longest_gap
+    int earliestStart = -1;     // minutes since midnight no session may start before
+    int latestEnd = -1;         // minutes since midnight no session may end after
+    vector<int> forbiddenDays;  // 1 = Sunday ... 7 = Saturday
+
+    bool limitsGaps() const { return maxGaps >= 0 || maxGapTime >= 0; }
+
+    bool active() const {
+        return maxDays >= 0 || limitsGaps() || earliestStart >= 0 || latestEnd >= 0 || !forbiddenDays.empty();
+    }
+};
+
+struct ScheduleGenerationRequest {
+    vector<Course> courses;
+    ScheduleConstraints constraints;
+
+    ScheduleGenerationRequest() = default;
+    ScheduleGenerationRequest(const vector<Course>& courses, const ScheduleConstraints& constraints = {})
+            : courses(courses), constraints(constraints) {}
 };
 
 struct FileLoadData {
@@ -275,7 +318,8 @@ enum class ModelOperation {
     DELETE_FILE_FROM_HISTORY,
     CLEAN_SCHEDULES,
     CONVERT_UNIQUE_IDS_TO_INDICES,
-    CONVERT_INDICES_TO_UNIQUE_IDS
+    CONVERT_INDICES_TO_UNIQUE_IDS,
+    COUNT_SCHEDULES
 };
 
 class IModel {
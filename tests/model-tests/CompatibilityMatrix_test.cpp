@@ -0,0 +1,62 @@
+#include "CompatibilityMatrix.h"
+#include "CourseLegalComb.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+using namespace std;
+
+namespace {
+
+bool hasBit(const uint64_t* bits, size_t index) {
+    return bits[index / 64] & (uint64_t(1) << (index % 64));
+}
+
+}
+
+// --- TEST CASES ---
+
+// Compatibility is recorded symmetrically for both directions of a course pair
+TEST(CompatibilityMatrixTest, SymmetricPairBits) {
+    Course a = makeLectureCourse(1, {{makeSession(1, "09:00", "10:00")}, {makeSession(1, "11:00", "12:00")}});
+    Course b = makeLectureCourse(2, {{makeSession(1, "09:30", "10:30")}, {makeSession(2, "09:00", "10:00")},
+                                     {makeSession(1, "11:30", "12:30")}});
+
+    CourseLegalComb comb;
+    vector<vector<CourseSelection>> allOptions = {comb.generate(a), comb.generate(b)};
+
+    CompatibilityMatrix matrix;
+    matrix.build(allOptions);
+
+    // a0 (Sun 09-10) clashes with b0 only, a1 (Sun 11-12) clashes with b2 only
+    EXPECT_FALSE(hasBit(matrix.compatible(0, 0, 1), 0));
+    EXPECT_TRUE(hasBit(matrix.compatible(0, 0, 1), 1));
+    EXPECT_TRUE(hasBit(matrix.compatible(0, 0, 1), 2));
+    EXPECT_TRUE(hasBit(matrix.compatible(0, 1, 1), 0));
+    EXPECT_FALSE(hasBit(matrix.compatible(0, 1, 1), 2));
+
+    for (size_t x = 0; x < allOptions[0].size(); x++) {
+        for (size_t y = 0; y < allOptions[1].size(); y++) {
+            EXPECT_EQ(hasBit(matrix.compatible(0, x, 1), y), hasBit(matrix.compatible(1, y, 0), x));
+        }
+    }
+}
+
+// The all-options bitset covers exactly the course's options, across word boundaries
+TEST(CompatibilityMatrixTest, AllOptionsBitsetSpansWords) {
+    vector<vector<Session>> groups;
+    for (int i = 0; i < 70; i++) {
+        groups.push_back({makeSession(1 + i % 7, "08:00", "09:00")});
+    }
+    Course many = makeLectureCourse(3, groups);
+
+    CourseLegalComb comb;
+    vector<vector<CourseSelection>> allOptions = {comb.generate(many)};
+
+    CompatibilityMatrix matrix;
+    matrix.build(allOptions);
+
+    OptionBitset all = matrix.allOptionsOf(0);
+    ASSERT_EQ(all.size(), 2);
+    EXPECT_EQ(all[0], ~uint64_t(0));
+    EXPECT_EQ(all[1], (uint64_t(1) << 6) - 1);
+}
@@ -73,10 +73,10 @@ TEST_F(CourseLegalCombTest, SingleLectureOnly) {
     auto combinations = comb.generate(c);
     ASSERT_EQ(combinations.size(), 1);
     EXPECT_EQ(combinations[0].courseId, 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_EQ(combinations[0].tutorialGroup, nullptr);
-    EXPECT_EQ(combinations[0].labGroup, nullptr);
-    EXPECT_EQ(combinations[0].blockGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_EQ(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_EQ(combinations[0].labGroup(), nullptr);
+    EXPECT_EQ(combinations[0].blockGroup(), nullptr);
 }
 
 // All 3 session types without conflicts
@@ -94,10 +94,10 @@ TEST_F(CourseLegalCombTest, LectureWithTutorialAndLab) {
 
     auto combinations = comb.generate(c);
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].tutorialGroup, nullptr);
-    EXPECT_NE(combinations[0].labGroup, nullptr);
-    EXPECT_EQ(combinations[0].blockGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_NE(combinations[0].labGroup(), nullptr);
+    EXPECT_EQ(combinations[0].blockGroup(), nullptr);
 }
 
 // Tutorial overlaps with lecture → should be excluded
@@ -176,8 +176,8 @@ TEST_F(CourseLegalCombTest, OnlyLabsShouldReturnNothing) {
     } else {
 // If your implementation allows lab-only courses, that's fine too
         ASSERT_EQ(combinations.size(), 1) << "Lab-only course generates one combination";
-        EXPECT_EQ(combinations[0].lectureGroup, nullptr);
-        EXPECT_NE(combinations[0].labGroup, nullptr);
+        EXPECT_EQ(combinations[0].lectureGroup(), nullptr);
+        EXPECT_NE(combinations[0].labGroup(), nullptr);
     }
 }
 
@@ -216,8 +216,8 @@ TEST_F(CourseLegalCombTest, SomeCombinationsValidAmongMany) {
 
     auto combinations = comb.generate(c);
     ASSERT_EQ(combinations.size(), 1); // Only one fully non-overlapping combo
-    EXPECT_EQ(combinations[0].tutorialGroup->sessions[0].start_time, "09:30");
-    EXPECT_EQ(combinations[0].labGroup->sessions[0].start_time, "10:30");
+    EXPECT_EQ(combinations[0].tutorialGroup()->sessions[0].start_time, "09:30");
+    EXPECT_EQ(combinations[0].labGroup()->sessions[0].start_time, "10:30");
 }
 
 // Test conflicting sessions within the same group (should be handled properly)
@@ -295,10 +295,10 @@ TEST_F(CourseLegalCombTest, LectureWithTutorialNoLab) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].tutorialGroup, nullptr);
-    EXPECT_EQ(combinations[0].labGroup, nullptr);
-    EXPECT_EQ(combinations[0].blockGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_EQ(combinations[0].labGroup(), nullptr);
+    EXPECT_EQ(combinations[0].blockGroup(), nullptr);
 }
 
 // Test lecture with lab but no tutorial
@@ -313,10 +313,10 @@ TEST_F(CourseLegalCombTest, LectureWithLabNoTutorial) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_EQ(combinations[0].tutorialGroup, nullptr);
-    EXPECT_NE(combinations[0].labGroup, nullptr);
-    EXPECT_EQ(combinations[0].blockGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_EQ(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_NE(combinations[0].labGroup(), nullptr);
+    EXPECT_EQ(combinations[0].blockGroup(), nullptr);
 }
 
 // Test multiple lecture groups with multiple tutorial groups (all valid)
@@ -352,10 +352,10 @@ TEST_F(CourseLegalCombTest, LectureWithDepartmentalSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].departmentalGroup, nullptr);
-    EXPECT_EQ(combinations[0].tutorialGroup, nullptr);
-    EXPECT_EQ(combinations[0].labGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].departmentalGroup(), nullptr);
+    EXPECT_EQ(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_EQ(combinations[0].labGroup(), nullptr);
 }
 
 // Test with reinforcement sessions
@@ -370,9 +370,9 @@ TEST_F(CourseLegalCombTest, LectureWithReinforcementSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].reinforcementGroup, nullptr);
-    EXPECT_EQ(combinations[0].tutorialGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].reinforcementGroup(), nullptr);
+    EXPECT_EQ(combinations[0].tutorialGroup(), nullptr);
 }
 
 // Test with guidance sessions
@@ -387,8 +387,8 @@ TEST_F(CourseLegalCombTest, LectureWithGuidanceSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].guidanceGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].guidanceGroup(), nullptr);
 }
 
 // Test with optional colloquium
@@ -403,8 +403,8 @@ TEST_F(CourseLegalCombTest, LectureWithOptionalColloquium) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].colloquiumGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].colloquiumGroup(), nullptr);
 }
 
 // Test with registration sessions
@@ -419,8 +419,8 @@ TEST_F(CourseLegalCombTest, LectureWithRegistrationSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].registrationGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].registrationGroup(), nullptr);
 }
 
 // Test with thesis sessions
@@ -435,8 +435,8 @@ TEST_F(CourseLegalCombTest, LectureWithThesisSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].thesisGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].thesisGroup(), nullptr);
 }
 
 // Test with project sessions
@@ -451,8 +451,8 @@ TEST_F(CourseLegalCombTest, LectureWithProjectSessions) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].projectGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].projectGroup(), nullptr);
 }
 
 // Test complex scenario with multiple new session types
@@ -473,10 +473,10 @@ TEST_F(CourseLegalCombTest, ComplexMultipleNewSessionTypes) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].departmentalGroup, nullptr);
-    EXPECT_NE(combinations[0].reinforcementGroup, nullptr);
-    EXPECT_NE(combinations[0].guidanceGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].departmentalGroup(), nullptr);
+    EXPECT_NE(combinations[0].reinforcementGroup(), nullptr);
+    EXPECT_NE(combinations[0].guidanceGroup(), nullptr);
 }
 
 // Test conflicts between new session types
@@ -508,7 +508,7 @@ TEST_F(CourseLegalCombTest, CourseWithSemesterField) {
 
     ASSERT_EQ(combinations.size(), 1);
     EXPECT_EQ(combinations[0].courseId, 25);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
 }
 
 // Test empty group handling for new session types
@@ -545,9 +545,9 @@ TEST_F(CourseLegalCombTest, DifferentDaysNoConflicts) {
 
 // Should work fine since all are on different days
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].tutorialGroup, nullptr);
-    EXPECT_NE(combinations[0].labGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_NE(combinations[0].labGroup(), nullptr);
 }
 
 // Test adjacent time slots (touching but not overlapping)
@@ -566,9 +566,9 @@ TEST_F(CourseLegalCombTest, AdjacentTimeSlots) {
 
 // Adjacent times should NOT conflict
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].tutorialGroup, nullptr);
-    EXPECT_NE(combinations[0].labGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].tutorialGroup(), nullptr);
+    EXPECT_NE(combinations[0].labGroup(), nullptr);
 }
 
 // Test overlapping sessions with 1-minute overlap
@@ -702,7 +702,7 @@ TEST_F(CourseLegalCombTest, AdjacentBlocksShouldWork) {
 
 // Adjacent blocks should not conflict
     EXPECT_GE(combinations.size(), 1);
-    EXPECT_NE(combinations[0].blockGroup, nullptr);
+    EXPECT_NE(combinations[0].blockGroup(), nullptr);
 }
 
 // Test all new session types together without conflicts
@@ -737,14 +737,14 @@ TEST_F(CourseLegalCombTest, AllNewSessionTypesNoConflicts) {
     auto combinations = comb.generate(c);
 
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_NE(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].departmentalGroup, nullptr);
-    EXPECT_NE(combinations[0].reinforcementGroup, nullptr);
-    EXPECT_NE(combinations[0].guidanceGroup, nullptr);
-    EXPECT_NE(combinations[0].colloquiumGroup, nullptr);
-    EXPECT_NE(combinations[0].registrationGroup, nullptr);
-    EXPECT_NE(combinations[0].thesisGroup, nullptr);
-    EXPECT_NE(combinations[0].projectGroup, nullptr);
+    EXPECT_NE(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].departmentalGroup(), nullptr);
+    EXPECT_NE(combinations[0].reinforcementGroup(), nullptr);
+    EXPECT_NE(combinations[0].guidanceGroup(), nullptr);
+    EXPECT_NE(combinations[0].colloquiumGroup(), nullptr);
+    EXPECT_NE(combinations[0].registrationGroup(), nullptr);
+    EXPECT_NE(combinations[0].thesisGroup(), nullptr);
+    EXPECT_NE(combinations[0].projectGroup(), nullptr);
 }
 
 // Test multiple groups of new session types
@@ -809,8 +809,8 @@ TEST_F(CourseLegalCombTest, OnlyThesisSessionType) {
 
 // Should work even without lectures for thesis-only courses
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_EQ(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].thesisGroup, nullptr);
+    EXPECT_EQ(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].thesisGroup(), nullptr);
 }
 
 // Test edge case: course with only project
@@ -823,8 +823,8 @@ TEST_F(CourseLegalCombTest, OnlyProjectSessionType) {
 
 // Should work even without lectures for project-only courses
     ASSERT_EQ(combinations.size(), 1);
-    EXPECT_EQ(combinations[0].lectureGroup, nullptr);
-    EXPECT_NE(combinations[0].projectGroup, nullptr);
+    EXPECT_EQ(combinations[0].lectureGroup(), nullptr);
+    EXPECT_NE(combinations[0].projectGroup(), nullptr);
 }
 
 // Test complex scheduling with overlapping new session types
@@ -876,8 +876,61 @@ TEST_F(CourseLegalCombTest, StressTestManySessionTypes) {
 
 // Verify each combination has all required session types
     for (const auto &combo: combinations) {
-        EXPECT_NE(combo.lectureGroup, nullptr);
-        EXPECT_NE(combo.departmentalGroup, nullptr);
-        EXPECT_NE(combo.reinforcementGroup, nullptr);
+        EXPECT_NE(combo.lectureGroup(), nullptr);
+        EXPECT_NE(combo.departmentalGroup(), nullptr);
+        EXPECT_NE(combo.reinforcementGroup(), nullptr);
     }
-}
\ No newline at end of file
+}
+// Pruning: partial combinations are dropped at the first conflict, and an off-grid session is
+// compared by its exact times
+TEST_F(CourseLegalCombTest, PrunedCombinationsMatchFullProduct) {
+    vector<Group> lectures = {
+            makeGroup(SessionType::LECTURE, {makeSession("08:00", "10:00", Mon)}),
+            makeGroup(SessionType::LECTURE, {makeSession("12:00", "14:00", Mon)})
+    };
+    vector<Group> tutorials;
+    for (int i = 0; i < 6; i++) {
+        tutorials.push_back(makeGroup(SessionType::TUTORIAL,
+                                      {makeSession(to_string(10 + i) + ":00", to_string(11 + i) + ":00", Mon)}));
+    }
+    vector<Group> labs = {
+            makeGroup(SessionType::LAB, {makeSession("08:30", "09:00", Mon)}),
+            makeGroup(SessionType::LAB, {makeSession("09:58", "10:02", Mon)}),
+            makeGroup(SessionType::LAB, {makeSession("10:59", "11:30", Tue)})
+    };
+
+    Course c = makeCourse(43, lectures, tutorials, labs);
+    auto combinations = comb.generate(c);
+
+    // 08:00 lecture: 6 tutorials with the Tuesday lab only. 12:00 lecture: 4 tutorials, of which
+    // the 10:00 one also clashes with the 09:58 lab.
+    ASSERT_EQ(combinations.size(), 6 + 4 + 3 + 4);
+    for (const auto &combo: combinations) {
+        if (combo.lectureGroup() == &c.Lectures[0]) {
+            EXPECT_EQ(combo.labGroup(), &c.labs[2]);
+        } else {
+            EXPECT_NE(combo.tutorialGroup(), &c.Tirgulim[2]);
+            EXPECT_NE(combo.tutorialGroup(), &c.Tirgulim[3]);
+            EXPECT_FALSE(combo.labGroup() == &c.labs[1] && combo.tutorialGroup() == &c.Tirgulim[0]);
+        }
+    }
+}
+
+// Every combination carries the parsed times of all its sessions
+TEST_F(CourseLegalCombTest, CombinationsCarrySessionTimes) {
+    Group lectureGroup = makeGroup(SessionType::LECTURE, {makeSession("08:00", "10:00", Mon),
+                                                          makeSession("09:15", "10:45", Wed)});
+    Group labGroup = makeGroup(SessionType::LAB, {makeSession("12:05", "13:00", Thu)});
+
+    Course c = makeCourse(44, {lectureGroup}, {}, {labGroup});
+    auto combinations = comb.generate(c);
+
+    ASSERT_EQ(combinations.size(), 1);
+    const auto &times = combinations[0].sessionTimes;
+    ASSERT_EQ(times.size(), 3);
+    EXPECT_EQ(times[0].day, Mon);
+    EXPECT_EQ(times[0].start, 8 * 60);
+    EXPECT_EQ(times[1].end, 10 * 60 + 45);
+    EXPECT_EQ(times[2].day, Thu);
+    EXPECT_EQ(times[2].start, 12 * 60 + 5);
+}
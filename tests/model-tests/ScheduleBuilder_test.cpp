@@ -2,6 +2,7 @@
 #include "gtest/gtest.h"
 #include "parseCoursesToVector.h"
 #include "model_interfaces.h"
+#include <set>
 
 using namespace std;
 
@@ -59,7 +60,7 @@ TEST(ScheduleBuilderTest, OneCourse_NoConflictWithinCourse) {
 
     Course course = makeCourse(101, {lectureGroup}, {tutorialGroup});
 
-    vector<InformativeSchedule> result = builder.build({course});
+    vector<InformativeSchedule> result = builder.build({course}, "A");
     ASSERT_EQ(result.size(), 1);  // One valid schedule
 }
 
@@ -77,7 +78,7 @@ TEST(ScheduleBuilderTest, TwoCourses_WithConflict) {
     Group lectureGroupB = makeGroup(SessionType::LECTURE, lectureSessionsB);
     Course courseB = makeCourse(102, {lectureGroupB});
 
-    vector<InformativeSchedule> result = builder.build({courseA, courseB});
+    vector<InformativeSchedule> result = builder.build({courseA, courseB}, "A");
     ASSERT_EQ(result.size(), 0);  // No valid schedules due to conflict
 }
 
@@ -95,7 +96,7 @@ TEST(ScheduleBuilderTest, TwoCourses_NoConflict) {
     Group lectureGroupB = makeGroup(SessionType::LECTURE, lectureSessionsB);
     Course courseB = makeCourse(102, {lectureGroupB});
 
-    vector<InformativeSchedule> result = builder.build({courseA, courseB});
+    vector<InformativeSchedule> result = builder.build({courseA, courseB}, "A");
     ASSERT_EQ(result.size(), 1);  // One valid schedule
 }
 
@@ -107,7 +108,7 @@ TEST(ScheduleBuilderTest, NoTutorialOrLab) {
     Group lectureGroup = makeGroup(SessionType::LECTURE, lectureSessions);
     Course course = makeCourse(201, {lectureGroup});
 
-    vector<InformativeSchedule> result = builder.build({course});
+    vector<InformativeSchedule> result = builder.build({course}, "A");
     ASSERT_EQ(result.size(), 1);  // Should handle lack of tutorials/labs
 }
 
@@ -133,14 +134,14 @@ TEST(ScheduleBuilderTest, MultipleCombinations) {
 
     Course courseB = makeCourse(302, {lectureGroupB1, lectureGroupB2});
 
-    vector<InformativeSchedule> result = builder.build({courseA, courseB});
+    vector<InformativeSchedule> result = builder.build({courseA, courseB}, "A");
     ASSERT_EQ(result.size(), 4);  // 2 lecture groups per course = 2x2 = 4 valid combos
 }
 
 // Edge case: no courses given
 TEST(ScheduleBuilderTest, EmptyCourseList) {
     ScheduleBuilder builder;
-    vector<InformativeSchedule> result = builder.build({});
+    vector<InformativeSchedule> result = builder.build({}, "A");
     ASSERT_EQ(result.size(), 1);  // One "empty" valid schedule (base case)
 }
 
@@ -152,7 +153,7 @@ TEST(ScheduleBuilderTest, OneCourse_OneSessionOnly) {
     Group lectureGroup = makeGroup(SessionType::LECTURE, lectureSessions);
     Course course = makeCourse(501, {lectureGroup});
 
-    vector<InformativeSchedule> result = builder.build({course});
+    vector<InformativeSchedule> result = builder.build({course}, "A");
     ASSERT_EQ(result.size(), 1);  // Only one option, should be valid
 }
 
@@ -170,7 +171,7 @@ TEST(ScheduleBuilderTest, MultipleCourses_ExactSameTimes) {
     Course course2 = makeCourse(602, {lectureGroup2});
     Course course3 = makeCourse(603, {lectureGroup3});
 
-    vector<InformativeSchedule> result = builder.build({course1, course2, course3});
+    vector<InformativeSchedule> result = builder.build({course1, course2, course3}, "A");
     ASSERT_EQ(result.size(), 0);  // All conflict with each other
 }
 
@@ -186,7 +187,7 @@ TEST(ScheduleBuilderTest, CoursesWithNoTutorialOrLab_EmptyVectorsHandled) {
     Group lectureGroupB = makeGroup(SessionType::LECTURE, lectureSessionsB);
     Course course2 = makeCourse(702, {lectureGroupB});
 
-    vector<InformativeSchedule> result = builder.build({course1, course2});
+    vector<InformativeSchedule> result = builder.build({course1, course2}, "A");
     ASSERT_EQ(result.size(), 1);  // Should produce one valid schedule
 }
 
@@ -206,7 +207,7 @@ TEST(ScheduleBuilderTest, LargeInput_NoConflicts) {
         manyCourses.push_back(makeCourse(800 + i, {lectureGroup}));
     }
 
-    vector<InformativeSchedule> result = builder.build(manyCourses);
+    vector<InformativeSchedule> result = builder.build(manyCourses, "A");
     ASSERT_EQ(result.size(), 1);  // One valid schedule including all 10 courses
 }
 
@@ -227,7 +228,7 @@ TEST(ScheduleBuilderTest, ChainedConflictsBlocksAllSchedules) {
     Group lectureGroupC = makeGroup(SessionType::LECTURE, lectureSessionsC);
     Course c = makeCourse(1103, {lectureGroupC});
 
-    vector<InformativeSchedule> result = builder.build({a, b, c});
+    vector<InformativeSchedule> result = builder.build({a, b, c}, "A");
     ASSERT_EQ(result.size(), 0);  // All schedules blocked due to transitive conflict
 }
 
@@ -243,7 +244,7 @@ TEST(ScheduleBuilderTest, ScheduleContainsCorrectTimes) {
     Group lectureGroupB = makeGroup(SessionType::LECTURE, lectureSessionsB);
     Course courseB = makeCourse(1302, {lectureGroupB});
 
-    vector<InformativeSchedule> result = builder.build({courseA, courseB});
+    vector<InformativeSchedule> result = builder.build({courseA, courseB}, "A");
     ASSERT_EQ(result.size(), 1);  // Should succeed
 
     const InformativeSchedule& sched = result[0];
@@ -264,7 +265,7 @@ TEST(ScheduleBuilderTest, MultipleGroupsSameType) {
 
     Course course = makeCourse(1401, {lectureGroup1, lectureGroup2});
 
-    vector<InformativeSchedule> result = builder.build({course});
+    vector<InformativeSchedule> result = builder.build({course}, "A");
     ASSERT_EQ(result.size(), 2);  // Two possible schedules (one per lecture group)
 }
 
@@ -286,6 +287,536 @@ TEST(ScheduleBuilderTest, AllSessionTypes) {
 
     Course course = makeCourse(1501, {lectureGroup}, {tutorialGroup}, {labGroup}, {blockGroup});
 
-    vector<InformativeSchedule> result = builder.build({course});
+    vector<InformativeSchedule> result = builder.build({course}, "A");
     ASSERT_EQ(result.size(), 1);  // Should handle all session types
-}
\ No newline at end of file
+}
+
+// Sessions off the 5-minute slot grid fall back to exact session checks
+TEST(ScheduleBuilderTest, UnalignedTimes_NoFalseConflict) {
+    ScheduleBuilder builder;
+
+    Group lectureGroupA = makeGroup(SessionType::LECTURE, {makeTestSession(2, "10:00", "10:02")});
+    Course courseA = makeCourse(1601, {lectureGroupA});
+
+    Group lectureGroupB = makeGroup(SessionType::LECTURE, {makeTestSession(2, "10:03", "11:00")});
+    Course courseB = makeCourse(1602, {lectureGroupB});
+
+    vector<InformativeSchedule> result = builder.build({courseA, courseB}, "A");
+    ASSERT_EQ(result.size(), 1);  // Same 5-minute slot but no real overlap
+}
+
+// A conflict with any earlier course is caught by the aggregate occupancy mask
+TEST(ScheduleBuilderTest, AggregateMask_ConflictWithFirstCourse) {
+    ScheduleBuilder builder;
+
+    Course courseA = makeCourse(1701, {makeGroup(SessionType::LECTURE, {makeTestSession(3, "08:00", "10:00")})});
+    Course courseB = makeCourse(1702, {makeGroup(SessionType::LECTURE, {makeTestSession(4, "08:00", "10:00")})});
+
+    // Course C has one option clashing with A and one free option
+    Group clashing = makeGroup(SessionType::LECTURE, {makeTestSession(3, "09:55", "11:00")});
+    Group free = makeGroup(SessionType::LECTURE, {makeTestSession(3, "10:00", "11:00")});
+    Course courseC = makeCourse(1703, {clashing, free});
+
+    vector<InformativeSchedule> result = builder.build({courseA, courseB, courseC}, "A");
+    ASSERT_EQ(result.size(), 1);
+}
+
+// Parallel enumeration yields the same schedules in the same order as the serial backtracker
+TEST(ScheduleBuilderTest, Parallel_MatchesSerialOrder) {
+    vector<Course> courses;
+    for (int c = 0; c < 4; ++c) {
+        vector<Group> lectures;
+        for (int g = 0; g < 4; ++g) {
+            int hour = 8 + g * 2 + (c % 2);
+            string start = (hour < 10 ? "0" : "") + to_string(hour) + ":00";
+            string end = (hour + 1 < 10 ? "0" : "") + to_string(hour + 1) + ":30";
+            lectures.push_back(makeGroup(SessionType::LECTURE, {makeTestSession(1 + (c + g) % 3, start, end)}));
+        }
+        courses.push_back(makeCourse(1800 + c, lectures));
+    }
+
+    ScheduleBuilder serialBuilder;
+    serialBuilder.setThreadCount(1);
+    vector<InformativeSchedule> serial = serialBuilder.build(courses, "A");
+
+    ScheduleBuilder parallelBuilder;
+    parallelBuilder.setThreadCount(4);
+    vector<InformativeSchedule> parallel = parallelBuilder.build(courses, "A");
+
+    ASSERT_GT(serial.size(), 1);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(parallel[i].index, static_cast<int>(i));
+        ASSERT_EQ(serial[i].week.size(), parallel[i].week.size());
+        for (size_t d = 0; d < serial[i].week.size(); ++d) {
+            const auto& serialItems = serial[i].week[d].day_items;
+            const auto& parallelItems = parallel[i].week[d].day_items;
+            ASSERT_EQ(serialItems.size(), parallelItems.size());
+            for (size_t k = 0; k < serialItems.size(); ++k) {
+                EXPECT_EQ(serialItems[k].raw_id, parallelItems[k].raw_id);
+                EXPECT_EQ(serialItems[k].start, parallelItems[k].start);
+            }
+        }
+    }
+}
+
+// Constraint propagation finds the same schedules in the same order as the default search
+TEST(ScheduleBuilderTest, ConstraintPropagation_MatchesDefaultOrder) {
+    vector<Course> courses;
+    for (int c = 0; c < 3; ++c) {
+        vector<Group> lectures;
+        string start = "0" + to_string(8 + c) + ":00";
+        string end = (9 + c < 10 ? "0" : "") + to_string(9 + c) + ":00";
+        for (int g = 0; g < 3; ++g) {
+            lectures.push_back(makeGroup(SessionType::LECTURE, {makeTestSession(1 + g, start, end)}));
+        }
+        courses.push_back(makeCourse(1900 + c, lectures));
+    }
+
+    // The last course has a single option that rules out every Sunday lecture
+    courses.push_back(makeCourse(1903, {makeGroup(SessionType::LECTURE, {makeTestSession(1, "08:00", "11:00")})}));
+
+    ScheduleBuilder defaultBuilder;
+    vector<InformativeSchedule> expected = defaultBuilder.build(courses, "A");
+
+    ScheduleBuilder propagatingBuilder;
+    propagatingBuilder.setConstraintPropagation(true);
+    vector<InformativeSchedule> result = propagatingBuilder.build(courses, "A");
+
+    ASSERT_EQ(expected.size(), 8);  // 2 remaining options for each of the first three courses
+    ASSERT_EQ(result.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(result[i].index, static_cast<int>(i));
+        EXPECT_EQ(result[i].days_json, expected[i].days_json);
+        for (size_t d = 0; d < expected[i].week.size(); ++d) {
+            ASSERT_EQ(result[i].week[d].day_items.size(), expected[i].week[d].day_items.size());
+            for (size_t k = 0; k < expected[i].week[d].day_items.size(); ++k) {
+                EXPECT_EQ(result[i].week[d].day_items[k].raw_id, expected[i].week[d].day_items[k].raw_id);
+            }
+        }
+    }
+}
+
+// Builds courses on separate days so every combination is valid (4^4 = 256 schedules)
+static vector<Course> makeIndependentCourses() {
+    vector<Course> courses;
+    for (int c = 0; c < 4; ++c) {
+        vector<Group> lectures;
+        for (int g = 0; g < 4; ++g) {
+            int hour = 10 + g;
+            lectures.push_back(makeGroup(SessionType::LECTURE,
+                                         {makeTestSession(c + 1, to_string(hour) + ":00", to_string(hour) + ":45")}));
+        }
+        courses.push_back(makeCourse(1900 + c, lectures));
+    }
+    return courses;
+}
+
+// Streamed chunks arrive in the same order as build() and respect the chunk size
+TEST(ScheduleBuilderTest, Streaming_ChunksMatchBuild) {
+    vector<Course> courses = makeIndependentCourses();
+
+    ScheduleBuilder serialBuilder;
+    serialBuilder.setThreadCount(1);
+    vector<InformativeSchedule> expected = serialBuilder.build(courses, "A");
+    ASSERT_EQ(expected.size(), 256);
+
+    ScheduleBuilder streamingBuilder;
+    streamingBuilder.setThreadCount(4);
+    vector<InformativeSchedule> streamed;
+    size_t delivered = streamingBuilder.buildStreaming(courses, "A", [&](vector<InformativeSchedule>& chunk) {
+        EXPECT_LE(chunk.size(), 7);
+        streamed.insert(streamed.end(), chunk.begin(), chunk.end());
+        return true;
+    }, 7);
+
+    ASSERT_EQ(delivered, expected.size());
+    ASSERT_EQ(streamed.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(streamed[i].index, static_cast<int>(i));
+        ASSERT_EQ(streamed[i].week.size(), expected[i].week.size());
+        for (size_t d = 0; d < expected[i].week.size(); ++d) {
+            const auto& expectedItems = expected[i].week[d].day_items;
+            const auto& streamedItems = streamed[i].week[d].day_items;
+            ASSERT_EQ(expectedItems.size(), streamedItems.size());
+            for (size_t k = 0; k < expectedItems.size(); ++k) {
+                EXPECT_EQ(expectedItems[k].start, streamedItems[k].start);
+            }
+        }
+    }
+}
+
+// The schedule limit is configurable and the consumer can stop the generation
+TEST(ScheduleBuilderTest, Streaming_LimitAndEarlyStop) {
+    vector<Course> courses = makeIndependentCourses();
+
+    ScheduleBuilder limitedBuilder;
+    limitedBuilder.setThreadCount(3);
+    limitedBuilder.setMaxSchedules(100);
+    EXPECT_EQ(limitedBuilder.build(courses, "A").size(), 100);
+
+    ScheduleBuilder stoppingBuilder;
+    stoppingBuilder.setThreadCount(3);
+    stoppingBuilder.setMaxSchedules(0);
+    int chunks = 0;
+    size_t delivered = stoppingBuilder.buildStreaming(courses, "A", [&](vector<InformativeSchedule>&) {
+        return ++chunks < 2;
+    }, 10);
+
+    EXPECT_EQ(chunks, 2);
+    EXPECT_EQ(delivered, 20);
+}
+
+// An exception escaping a search task stops the generation and releases the tasks waiting
+// behind it in the ordered stream
+TEST(ScheduleBuilderTest, Streaming_ThrowingTaskStopsGeneration) {
+    vector<Course> courses = makeIndependentCourses();
+
+    ScheduleBuilder builder;
+    builder.setThreadCount(4);
+    int chunks = 0;
+    builder.buildStreaming(courses, "A", [&](vector<InformativeSchedule>&) -> bool {
+        ++chunks;
+        throw 42;  // Not a std::exception, so only the task itself can catch it
+    }, 10);
+
+    EXPECT_EQ(chunks, 1);
+}
+
+// Top-K search returns the same schedules as sorting the full enumeration by the objective
+TEST(ScheduleBuilderTest, TopK_MatchesSortedFullBuild) {
+    vector<Course> courses;
+    for (int c = 0; c < 4; ++c) {
+        vector<Group> lectures;
+        vector<Group> tutorials;
+        for (int g = 0; g < 3; ++g) {
+            int hour = 8 + ((c * 3 + g * 5) % 10);
+            string start = (hour < 10 ? "0" : "") + to_string(hour) + ":00";
+            string end = (hour + 1 < 10 ? "0" : "") + to_string(hour + 1) + ":30";
+            lectures.push_back(makeGroup(SessionType::LECTURE, {makeTestSession(1 + (c + g) % 5, start, end)}));
+            tutorials.push_back(makeGroup(SessionType::TUTORIAL, {makeTestSession(1 + (c * 2 + g) % 5, end, (hour + 3 < 10 ? "0" : "") + to_string(hour + 3) + ":00")}));
+        }
+        courses.push_back(makeCourse(2000 + c, lectures, tutorials));
+    }
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> all = fullBuilder.build(courses, "A");
+    ASSERT_GT(all.size(), 10);
+
+    vector<ScheduleObjective> objectives = {
+            ScheduleObjective(ScheduleMetric::AMOUNT_DAYS),
+            ScheduleObjective(ScheduleMetric::GAPS_TIME),
+            ScheduleObjective({{ScheduleMetric::AMOUNT_DAYS, 100.0}, {ScheduleMetric::AMOUNT_GAPS, 10.0},
+                               {ScheduleMetric::AVG_START, -0.5}}),
+            ScheduleObjective(ScheduleMetric::SCHEDULE_SPAN)
+    };
+
+    for (const auto& objective : objectives) {
+        vector<InformativeSchedule> expected = all;
+        stable_sort(expected.begin(), expected.end(), [&](const InformativeSchedule& a, const InformativeSchedule& b) {
+            return objective.evaluate(a) < objective.evaluate(b);
+        });
+
+        ScheduleBuilder topBuilder;
+        vector<InformativeSchedule> top = topBuilder.buildTopK(courses, "A", objective, 5);
+
+        ASSERT_EQ(top.size(), 5);
+        for (size_t i = 0; i < top.size(); ++i) {
+            EXPECT_EQ(top[i].index, static_cast<int>(i));
+            EXPECT_EQ(objective.evaluate(top[i]), objective.evaluate(expected[i]));
+            EXPECT_EQ(top[i].days_json, expected[i].days_json);
+            EXPECT_EQ(top[i].avg_start, expected[i].avg_start);
+        }
+    }
+}
+
+// Counting matches the number of schedules a full build produces, ignoring the schedule limit
+TEST(ScheduleBuilderTest, CountSchedules_MatchesBuild) {
+    ScheduleBuilder independentBuilder;
+    EXPECT_EQ(independentBuilder.countSchedules(makeIndependentCourses()), 256);
+
+    vector<Course> courses;
+    for (int c = 0; c < 3; ++c) {
+        vector<Group> lectures;
+        vector<Group> tutorials;
+        for (int g = 0; g < 3; ++g) {
+            int hour = 8 + ((c + g * 2) % 6);
+            string start = (hour < 10 ? "0" : "") + to_string(hour) + ":00";
+            string end = (hour + 2 < 10 ? "0" : "") + to_string(hour + 2) + ":00";
+            lectures.push_back(makeGroup(SessionType::LECTURE, {makeTestSession(1 + g % 2, start, end)}));
+            tutorials.push_back(makeGroup(SessionType::TUTORIAL, {makeTestSession(3 + c % 2, start, end)}));
+        }
+        courses.push_back(makeCourse(2100 + c, lectures, tutorials));
+    }
+
+    ScheduleBuilder fullBuilder;
+    fullBuilder.setMaxSchedules(0);
+    size_t built = fullBuilder.build(courses, "A").size();
+    ASSERT_GT(built, 0);
+
+    ScheduleBuilder countingBuilder;
+    countingBuilder.setMaxSchedules(1);
+    EXPECT_EQ(countingBuilder.countSchedules(courses), built);
+
+    ScheduleBuilder emptyBuilder;
+    EXPECT_EQ(emptyBuilder.countSchedules({}), emptyBuilder.build({}, "A").size());
+    EXPECT_EQ(emptyBuilder.countSchedules({}), 1);
+}
+
+// Tutorials that only differ by room share one search branch but still yield one schedule each
+TEST(ScheduleBuilderTest, CollapseEquivalentOptions_SameSchedules) {
+    vector<Group> tutorials;
+    for (int room = 0; room < 3; ++room) {
+        tutorials.push_back(makeGroup(SessionType::TUTORIAL,
+                                      {makeTestSession(2, "10:00", "11:00", "B", to_string(room))}));
+    }
+    tutorials.push_back(makeGroup(SessionType::TUTORIAL, {makeTestSession(3, "09:00", "10:00", "B", "9")}));
+
+    vector<Course> courses = {
+            makeCourse(2200, {makeGroup(SessionType::LECTURE, {makeTestSession(1, "09:00", "11:00")})}, tutorials),
+            makeCourse(2201, {makeGroup(SessionType::LECTURE, {makeTestSession(2, "10:30", "12:00")}),
+                              makeGroup(SessionType::LECTURE, {makeTestSession(4, "10:30", "12:00")})})
+    };
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> full = fullBuilder.build(courses, "A");
+
+    ScheduleBuilder collapsedBuilder;
+    collapsedBuilder.setCollapseEquivalentOptions(true);
+    vector<InformativeSchedule> collapsed = collapsedBuilder.build(courses, "A");
+
+    // Day-2 tutorials in three rooms x Thursday lecture, plus the day-3 tutorial with both lectures
+    ASSERT_EQ(full.size(), 5);
+    ASSERT_EQ(collapsed.size(), full.size());
+
+    multiset<string> fullRooms, collapsedRooms;
+    for (size_t i = 0; i < full.size(); ++i) {
+        EXPECT_EQ(collapsed[i].index, static_cast<int>(i));
+        for (const auto& day : full[i].week) {
+            for (const auto& item : day.day_items) fullRooms.insert(day.day + item.start + item.room);
+        }
+        for (const auto& day : collapsed[i].week) {
+            for (const auto& item : day.day_items) collapsedRooms.insert(day.day + item.start + item.room);
+        }
+    }
+    EXPECT_EQ(collapsedRooms, fullRooms);
+}
+
+// Items and metrics follow the clock, not the text of the times ("9:00" comes before "10:30")
+TEST(ScheduleBuilderTest, MetricsUseIntegerTimes) {
+    vector<Course> courses = {
+            makeCourse(2300, {makeGroup(SessionType::LECTURE, {makeTestSession(2, "10:30", "12:00")})}),
+            makeCourse(2301, {makeGroup(SessionType::LECTURE, {makeTestSession(2, "9:00", "10:00")})})
+    };
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> result = builder.build(courses, "A");
+
+    ASSERT_EQ(result.size(), 1);
+    const auto& items = result[0].week[1].day_items;
+    ASSERT_EQ(items.size(), 2);
+    EXPECT_EQ(items[0].start, "9:00");
+    EXPECT_EQ(items[1].start, "10:30");
+
+    EXPECT_EQ(result[0].amount_gaps, 1);
+    EXPECT_EQ(result[0].gaps_time, 30);
+    EXPECT_EQ(result[0].earliest_start, 9 * 60);
+    EXPECT_EQ(result[0].latest_end, 12 * 60);
+    EXPECT_EQ(result[0].total_class_time, 150);
+}
+
+// Popping options restores the accumulator exactly, whatever order the sessions were pushed in
+TEST(ScheduleBuilderTest, MetricsAccumulator_PushPop) {
+    CourseSelection first{};
+    first.sessionTimes = {{2, 600, 690}, {4, 480, 540}};
+    CourseSelection second{};
+    second.sessionTimes = {{2, 540, 600}, {2, 720, 780}};
+
+    MetricsAccumulator metrics;
+    metrics.push(first);
+    metrics.push(second);
+
+    ASSERT_EQ(metrics.count(2), 3);
+    EXPECT_EQ(metrics.session(2, 0), make_pair(540, 600));
+    EXPECT_EQ(metrics.session(2, 1), make_pair(600, 690));
+    EXPECT_EQ(metrics.session(2, 2), make_pair(720, 780));
+    EXPECT_EQ(metrics.daysUsed(), 2);
+    EXPECT_EQ(metrics.classTime(), 90 + 60 + 60 + 60);
+    EXPECT_EQ(metrics.earliestStart(), 480);
+    EXPECT_EQ(metrics.latestEnd(), 780);
+    EXPECT_EQ(metrics.dayStart(2), 540);
+    EXPECT_EQ(metrics.dayEnd(2), 780);
+    EXPECT_EQ(metrics.dayClassTime(2), 90 + 60 + 60);
+    EXPECT_EQ(metrics.dayClassTime(4), 60);
+
+    metrics.pop();
+    ASSERT_EQ(metrics.count(2), 1);
+    EXPECT_EQ(metrics.session(2, 0), make_pair(600, 690));
+    EXPECT_EQ(metrics.classTime(), 150);
+    EXPECT_EQ(metrics.dayClassTime(2), 90);
+
+    metrics.pop();
+    EXPECT_EQ(metrics.count(2), 0);
+    EXPECT_EQ(metrics.count(4), 0);
+    EXPECT_EQ(metrics.daysUsed(), 0);
+    EXPECT_EQ(metrics.earliestStart(), INT_MAX);
+}
+
+// Overflow clears when the option that caused it is popped, and overflowing schedules still get
+// metrics from all of their sessions
+TEST(ScheduleBuilderTest, MetricsAccumulator_Overflow) {
+    CourseSelection base{};
+    base.sessionTimes = {{3, 480, 500}};
+    CourseSelection crowded{};
+    for (int i = 0; i < MetricsAccumulator::MAX_DAY_SESSIONS; i++) {
+        crowded.sessionTimes.push_back({3, 510 + i * 10, 515 + i * 10});
+    }
+
+    MetricsAccumulator metrics;
+    metrics.push(base);
+    metrics.push(crowded);
+    EXPECT_TRUE(metrics.overflowed());
+
+    metrics.pop();
+    EXPECT_FALSE(metrics.overflowed());
+    EXPECT_EQ(metrics.count(3), 1);
+    EXPECT_EQ(metrics.dayClassTime(3), 20);
+
+
+    vector<Session> sessions;
+    const int sessionCount = MetricsAccumulator::MAX_DAY_SESSIONS + 1;
+    for (int i = 0; i < sessionCount; i++) {
+        int start = 480 + i * 10;
+        char startText[6], endText[6];
+        snprintf(startText, sizeof(startText), "%02d:%02d", start / 60, start % 60);
+        snprintf(endText, sizeof(endText), "%02d:%02d", (start + 5) / 60, (start + 5) % 60);
+        sessions.push_back(makeTestSession(3, startText, endText));
+    }
+
+    ScheduleBuilder builder;
+    auto result = builder.build({makeCourse(2300, {makeGroup(SessionType::LECTURE, sessions)})}, "A");
+
+    ASSERT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].total_class_time, sessionCount * 5);
+    EXPECT_EQ(result[0].earliest_start, 480);
+    EXPECT_EQ(result[0].latest_end, 480 + (sessionCount - 1) * 10 + 5);
+    EXPECT_EQ(result[0].amount_days, 1);
+}
+
+// Constrained generation yields exactly the schedules of a full build that meet the limits, in order
+TEST(ScheduleBuilderTest, Constraints_MatchFilteredBuild) {
+    vector<Course> courses;
+    for (int c = 0; c < 3; ++c) {
+        vector<Group> lectures;
+        for (int g = 0; g < 5; ++g) {
+            int day = 2 + (c + g) % 5;
+            int hour = 8 + (c * 3 + g * 2) % 9;
+            lectures.push_back(makeGroup(SessionType::LECTURE,
+                                         {makeTestSession(day, to_string(hour) + ":00", to_string(hour + 1) + ":30")}));
+        }
+        courses.push_back(makeCourse(2400 + c, lectures));
+    }
+
+    ScheduleConstraints constraints;
+    constraints.maxDays = 2;
+    constraints.maxGaps = 1;
+    constraints.maxGapTime = 120;
+    constraints.earliestStart = 9 * 60;
+    constraints.latestEnd = 18 * 60;
+    constraints.forbiddenDays = {6};
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> expected;
+    for (const auto& schedule : fullBuilder.build(courses, "A")) {
+        if (schedule.amount_days <= 2 && schedule.amount_gaps <= 1 && schedule.longest_gap <= 120 &&
+            schedule.earliest_start >= 9 * 60 && schedule.latest_end <= 18 * 60 && !schedule.has_friday) {
+            expected.push_back(schedule);
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+
+    for (bool propagation : {false, true}) {
+        ScheduleBuilder builder;
+        builder.setThreadCount(2);
+        builder.setConstraintPropagation(propagation);
+        builder.setConstraints(constraints);
+        vector<InformativeSchedule> result = builder.build(courses, "A");
+
+        ASSERT_EQ(result.size(), expected.size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            EXPECT_EQ(result[i].index, static_cast<int>(i));
+            for (size_t d = 0; d < result[i].week.size(); ++d) {
+                const auto& items = result[i].week[d].day_items;
+                ASSERT_EQ(items.size(), expected[i].week[d].day_items.size());
+                for (size_t k = 0; k < items.size(); ++k) {
+                    EXPECT_EQ(items[k].raw_id, expected[i].week[d].day_items[k].raw_id);
+                    EXPECT_EQ(items[k].start, expected[i].week[d].day_items[k].start);
+                }
+            }
+        }
+    }
+}
+
+// IDs of one generation share their prefix, end with the index and parse back to their integer key
+TEST(ScheduleBuilderTest, UniqueIds_PerGenerationScheme) {
+    vector<Course> courses = makeIndependentCourses();
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> first = builder.build(courses, "A");
+    vector<InformativeSchedule> second = builder.build(courses, "A");
+    ASSERT_EQ(first.size(), 256);
+
+    const string prefix = first[0].unique_id.substr(0, first[0].unique_id.rfind('_') + 1);
+    set<string> ids;
+    set<uint64_t> keys;
+    for (const auto& schedule : first) {
+        EXPECT_EQ(schedule.unique_id, prefix + to_string(schedule.index));
+
+        uint64_t key = 0;
+        ASSERT_TRUE(ScheduleId::parseKey(schedule.unique_id, key));
+        EXPECT_EQ(key, schedule.unique_key);
+        ids.insert(schedule.unique_id);
+        keys.insert(schedule.unique_key);
+    }
+    for (const auto& schedule : second) {
+        ids.insert(schedule.unique_id);
+        keys.insert(schedule.unique_key);
+    }
+    EXPECT_EQ(ids.size(), first.size() + second.size());
+    EXPECT_EQ(keys.size(), first.size() + second.size());
+
+    // Once a session is reserved (e.g. stored in the database), later generations start above it
+    uint32_t reserved = static_cast<uint32_t>(second[0].unique_key >> 32) + 1000;
+    if (reserved > 1000 && reserved < UINT32_MAX) {  // the seed is random; skip if the sum wrapped
+        ScheduleId::reserveSessionsThrough(reserved);
+        EXPECT_EQ(builder.build(courses, "A")[0].unique_key >> 32, reserved + 1);
+    }
+
+    uint64_t key = 0;
+    EXPECT_FALSE(ScheduleId::parseKey("A_1700000000000_3_4821", key));
+}
+
+// Items of different schedules refer to one pooled copy of each string
+TEST(ScheduleBuilderTest, ScheduleItems_SharePooledStrings) {
+    vector<Course> courses = {
+            makeCourse(2500, {makeGroup(SessionType::LECTURE, {makeTestSession(2, "09:00", "10:00", "B1", "101")})},
+                       {makeGroup(SessionType::TUTORIAL, {makeTestSession(3, "09:00", "10:00", "B2", "201")}),
+                        makeGroup(SessionType::TUTORIAL, {makeTestSession(4, "09:00", "10:00", "B2", "202")})})
+    };
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> result = builder.build(courses, "A");
+    ASSERT_EQ(result.size(), 2);
+
+    const ScheduleItem& first = result[0].week[1].day_items.at(0);
+    const ScheduleItem& second = result[1].week[1].day_items.at(0);
+    EXPECT_EQ(&first.room.str(), &second.room.str());
+    EXPECT_EQ(&first.courseName.str(), &second.courseName.str());
+    EXPECT_EQ(first.room, "101");
+    EXPECT_EQ(first.type, "Lecture");
+    EXPECT_EQ(first.start + "-" + first.end, "09:00-10:00");
+
+    ScheduleItem copy;
+    copy.room = string("101");
+    EXPECT_EQ(copy.room, first.room);
+}
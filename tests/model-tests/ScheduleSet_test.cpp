@@ -0,0 +1,298 @@
+#include "ScheduleBuilder.h"
+#include "ScheduleSet.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+vector<Course> makeSetCourses() {
+    return {
+            makeLectureCourse(1, {{makeSession(1, "09:00", "10:00")}, {makeSession(2, "09:00", "10:00")}}),
+            makeLectureCourse(2, {{makeSession(1, "09:30", "11:00")}, {makeSession(3, "12:00", "14:00")},
+                                  {makeSession(2, "16:00", "17:00"), makeSession(4, "08:00", "09:00")}}),
+    };
+}
+
+}
+
+// --- TEST CASES ---
+
+// Compact schedules carry the same metrics as full ones and expand to the same week
+TEST(ScheduleSetTest, CompactMatchesFullBuild) {
+    vector<Course> courses = makeSetCourses();
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> full = fullBuilder.build(courses, "A");
+
+    ScheduleBuilder compactBuilder;
+    vector<InformativeSchedule> compact = compactBuilder.buildCompact(courses, "A");
+
+    ASSERT_EQ(full.size(), 5);
+    ASSERT_EQ(compact.size(), full.size());
+    for (size_t i = 0; i < full.size(); ++i) {
+        EXPECT_TRUE(compact[i].week.empty());
+        ASSERT_NE(compact[i].source, nullptr);
+        EXPECT_EQ(compact[i].index, full[i].index);
+        EXPECT_EQ(compact[i].amount_days, full[i].amount_days);
+        EXPECT_EQ(compact[i].gaps_time, full[i].gaps_time);
+        EXPECT_EQ(compact[i].earliest_start, full[i].earliest_start);
+        expectSameWeek(full[i].week, ScheduleSet::weekOf(compact[i]));
+    }
+}
+
+// Expansion only depends on the set, not on the caller's courses or later builds
+TEST(ScheduleSetTest, ExpandsAfterCoursesAreGone) {
+    vector<InformativeSchedule> compact;
+    {
+        vector<Course> courses = makeSetCourses();
+        ScheduleBuilder builder;
+        compact = builder.buildCompact(courses, "A");
+    }
+
+    ScheduleBuilder otherBuilder;
+    otherBuilder.build({makeLectureCourse(9, {{makeSession(5, "10:00", "11:00")}})}, "B");
+
+    ASSERT_FALSE(compact.empty());
+    InformativeSchedule schedule = ScheduleSet::expanded(compact.back());
+    ASSERT_EQ(schedule.week.size(), 7);
+
+    int items = 0;
+    for (const auto& day : schedule.week) {
+        for (const auto& item : day.day_items) {
+            EXPECT_TRUE(item.raw_id == "R1" || item.raw_id == "R2");
+            items++;
+        }
+    }
+    EXPECT_GT(items, 0);
+}
+
+// Chunks passed to the observer carry their tuples and expand on demand; no week is built for them
+TEST(ScheduleSetTest, ObserverSeesCompactChunks) {
+    ScheduleBuilder builder;
+    size_t observed = 0;
+    vector<InformativeSchedule> compact = builder.buildCompact(makeSetCourses(), "A",
+            [&](const vector<InformativeSchedule>& chunk) {
+                for (const auto& schedule : chunk) {
+                    EXPECT_TRUE(schedule.week.empty());
+                    EXPECT_TRUE(schedule.source && schedule.source->tupleOf(schedule.source_position).size() == 2);
+                    EXPECT_EQ(ScheduleSet::weekOf(schedule).size(), 7);
+                }
+                observed += chunk.size();
+                return true;
+            });
+
+    EXPECT_EQ(observed, compact.size());
+}
+
+// Adding a course to a previous set gives the schedules of a fresh build, in the same order
+TEST(ScheduleSetTest, ExtendWithAddedCourseMatchesFullBuild) {
+    vector<Course> courses = makeSetCourses();
+    ScheduleBuilder builder;
+    builder.buildCompact(courses, "A");
+    shared_ptr<const ScheduleSet> previous = builder.lastScheduleSet();
+    ASSERT_NE(previous, nullptr);
+
+    courses.insert(courses.begin() + 1, makeLectureCourse(3, {{makeSession(1, "10:00", "11:00")},
+                                                             {makeSession(3, "13:00", "14:00")}}));
+
+    vector<InformativeSchedule> extended;
+    ScheduleBuilder extendBuilder;
+    ASSERT_TRUE(extendBuilder.extendCompact(*previous, courses, "A", extended));
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> full = fullBuilder.build(courses, "A");
+
+    ASSERT_FALSE(full.empty());
+    ASSERT_EQ(extended.size(), full.size());
+    for (size_t i = 0; i < full.size(); ++i) {
+        EXPECT_EQ(extended[i].index, full[i].index);
+        EXPECT_EQ(extended[i].gaps_time, full[i].gaps_time);
+        expectSameWeek(full[i].week, ScheduleSet::weekOf(extended[i]));
+    }
+    EXPECT_EQ(extendBuilder.lastScheduleSet()->size(), full.size());
+}
+
+// A block-time course that only gains sessions filters the previous schedules
+TEST(ScheduleSetTest, ExtendWithNarrowedBlocks) {
+    Course blocks = makeLectureCourse(90000, {});
+    Group block;
+    block.type = SessionType::BLOCK;
+    block.sessions = {makeSession(5, "08:00", "09:00")};
+    blocks.blocks.push_back(block);
+
+    vector<Course> courses = makeSetCourses();
+    courses.push_back(blocks);
+
+    ScheduleBuilder builder;
+    builder.buildCompact(courses, "A");
+    shared_ptr<const ScheduleSet> previous = builder.lastScheduleSet();
+
+    courses.back().blocks[0].sessions.push_back(makeSession(3, "12:00", "13:00"));
+
+    vector<InformativeSchedule> extended;
+    ScheduleBuilder extendBuilder;
+    ASSERT_TRUE(extendBuilder.extendCompact(*previous, courses, "A", extended));
+
+    ScheduleBuilder fullBuilder;
+    vector<InformativeSchedule> full = fullBuilder.build(courses, "A");
+
+    ASSERT_LT(full.size(), previous->size());
+    ASSERT_EQ(extended.size(), full.size());
+    for (size_t i = 0; i < full.size(); ++i) {
+        expectSameWeek(full[i].week, ScheduleSet::weekOf(extended[i]));
+    }
+}
+
+// Removed or reshaped courses, and truncated previous results, need a full build
+TEST(ScheduleSetTest, ExtendRejectsOtherChanges) {
+    vector<Course> courses = makeSetCourses();
+    ScheduleBuilder builder;
+    builder.buildCompact(courses, "A");
+    shared_ptr<const ScheduleSet> previous = builder.lastScheduleSet();
+
+    vector<InformativeSchedule> results;
+    ScheduleBuilder extendBuilder;
+    EXPECT_FALSE(extendBuilder.extendCompact(*previous, {courses[0]}, "A", results));
+
+    vector<Course> changed = courses;
+    changed[1].Lectures.pop_back();
+    EXPECT_FALSE(extendBuilder.extendCompact(*previous, changed, "A", results));
+    EXPECT_TRUE(results.empty());
+
+    ScheduleBuilder limitedBuilder;
+    limitedBuilder.setMaxSchedules(2);
+    limitedBuilder.buildCompact(courses, "A");
+    EXPECT_FALSE(extendBuilder.extendCompact(*limitedBuilder.lastScheduleSet(), courses, "A", results));
+}
+
+// The option weeks of a schedule's tuple join back into its week
+TEST(ScheduleSetTest, OptionWeeksJoinIntoScheduleWeek) {
+    vector<Course> courses = makeSetCourses();
+    courses.push_back(makeLectureCourse(3, {{makeSession(1, "08:00", "09:00"), makeSession(5, "10:00", "11:00")},
+                                            {makeSession(1, "11:00", "12:00")}}));
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> compact = builder.buildCompact(courses, "A");
+    shared_ptr<const ScheduleSet> set = builder.lastScheduleSet();
+    ASSERT_FALSE(compact.empty());
+    ASSERT_EQ(set->courseCount(), courses.size());
+
+    for (const auto& schedule : compact) {
+        vector<uint32_t> tuple = set->tupleOf(schedule.source_position);
+        ASSERT_EQ(tuple.size(), courses.size());
+
+        vector<vector<ScheduleDay>> optionWeeks;
+        for (size_t course = 0; course < tuple.size(); ++course) {
+            optionWeeks.push_back(set->optionWeek(course, tuple[course]));
+        }
+        vector<const vector<ScheduleDay>*> parts;
+        for (const auto& optionWeek : optionWeeks) {
+            parts.push_back(&optionWeek);
+        }
+
+        expectSameWeek(ScheduleSet::weekOf(schedule), ScheduleSet::joinOptionWeeks(parts));
+    }
+}
+
+// A set rebuilt from stored option weeks expands the same weeks, and rejects unknown options
+TEST(ScheduleSetTest, StoredSetJoinsWeeksOnDemand) {
+    vector<Course> courses = makeSetCourses();
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> compact = builder.buildCompact(courses, "A");
+    shared_ptr<const ScheduleSet> set = builder.lastScheduleSet();
+    ASSERT_FALSE(compact.empty());
+
+    map<uint64_t, vector<ScheduleDay>> weeks;
+    for (const auto& schedule : compact) {
+        vector<uint32_t> tuple = set->tupleOf(schedule.source_position);
+        for (size_t course = 0; course < tuple.size(); ++course) {
+            weeks[(uint64_t(course) << 32) | tuple[course]] = set->optionWeek(course, tuple[course]);
+        }
+    }
+    auto stored = make_shared<ScheduleSet>(set->courseCount(), weeks);
+    EXPECT_TRUE(stored->fromStorage());
+
+    for (const auto& schedule : compact) {
+        InformativeSchedule loaded = schedule;
+        loaded.source = stored;
+        ASSERT_TRUE(stored->appendStored(set->tupleOf(schedule.source_position), loaded.source_position));
+        expectSameWeek(ScheduleSet::weekOf(schedule), ScheduleSet::weekOf(loaded));
+    }
+
+    size_t position = 0;
+    EXPECT_FALSE(stored->appendStored(vector<uint32_t>(set->courseCount(), 99), position));
+    EXPECT_FALSE(stored->appendStored({0}, position));
+    EXPECT_EQ(stored->size(), compact.size());
+}
+
+// Another thread can join option weeks of delivered schedules while generation still appends
+TEST(ScheduleSetTest, TuplesReadableDuringGeneration) {
+    vector<Course> courses;
+    for (int c = 0; c < 4; ++c) {
+        vector<vector<Session>> groups;
+        for (int g = 0; g < 4; ++g) {
+            string hour = to_string(10 + g);
+            groups.push_back({makeSession(c + 1, hour + ":00", hour + ":45")});
+        }
+        courses.push_back(makeLectureCourse(c + 1, groups));
+    }
+
+    // Expanded weeks to compare against, in the same order
+    vector<InformativeSchedule> full = ScheduleBuilder().build(courses, "A");
+
+    mutex queueMutex;
+    condition_variable queueChanged;
+    deque<InformativeSchedule> queue;
+    bool done = false;
+    size_t checked = 0;
+
+    thread reader([&]() {
+        unique_lock<mutex> lock(queueMutex);
+        while (true) {
+            queueChanged.wait(lock, [&]() { return done || !queue.empty(); });
+            if (queue.empty()) break;
+            InformativeSchedule schedule = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+
+            vector<uint32_t> tuple = schedule.source->tupleOf(schedule.source_position);
+            vector<vector<ScheduleDay>> optionWeeks;
+            for (size_t course = 0; course < tuple.size(); ++course) {
+                optionWeeks.push_back(schedule.source->optionWeek(course, tuple[course]));
+            }
+            vector<const vector<ScheduleDay>*> parts;
+            for (const auto& optionWeek : optionWeeks) {
+                parts.push_back(&optionWeek);
+            }
+            expectSameWeek(full[schedule.index].week, ScheduleSet::joinOptionWeeks(parts));
+
+            lock.lock();
+            checked++;
+        }
+    });
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> compact = builder.buildCompact(courses, "A",
+            [&](const vector<InformativeSchedule>& chunk) {
+                lock_guard<mutex> lock(queueMutex);
+                queue.insert(queue.end(), chunk.begin(), chunk.end());
+                queueChanged.notify_all();
+                return true;
+            });
+
+    {
+        lock_guard<mutex> lock(queueMutex);
+        done = true;
+        queueChanged.notify_all();
+    }
+    reader.join();
+
+    EXPECT_EQ(compact.size(), 256);
+    EXPECT_EQ(checked, compact.size());
+}
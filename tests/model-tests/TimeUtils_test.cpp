@@ -61,4 +61,39 @@ TEST(TimeUtilsTest, ToMinutes_InvalidFormat) {
     EXPECT_ANY_THROW(TimeUtils::toMinutes("invalid"));     // Not a time
     EXPECT_ANY_THROW(TimeUtils::toMinutes("25:61"));       // Invalid hour/minute
     EXPECT_ANY_THROW(TimeUtils::toMinutes("10"));          // Missing minutes
-}
\ No newline at end of file
+}
+
+// Compiling a session caches its start/end as minutes since midnight
+TEST(TimeUtilsTest, CompileSession_CachesMinutes) {
+    auto s = makeSession(2, "08:30", "10:15");
+
+    EXPECT_TRUE(TimeUtils::compileSession(s));
+    EXPECT_EQ(s.start_minutes, 510);
+    EXPECT_EQ(s.end_minutes, 615);
+}
+
+// Invalid time strings leave the session uncompiled
+TEST(TimeUtilsTest, CompileSession_InvalidFormat) {
+    auto s = makeSession(2, "invalid", "10:15");
+
+    EXPECT_FALSE(TimeUtils::compileSession(s));
+    EXPECT_EQ(s.start_minutes, -1);
+    EXPECT_EQ(s.end_minutes, -1);
+}
+
+// Compiled and uncompiled sessions give the same overlap result
+TEST(TimeUtilsTest, IsOverlap_CompiledMatchesStrings) {
+    auto s1 = makeSession(4, "10:00", "12:00");
+    auto s2 = makeSession(4, "11:30", "13:00");
+    EXPECT_TRUE(TimeUtils::isOverlap(&s1, &s2));
+
+    TimeUtils::compileSession(s1);
+    EXPECT_TRUE(TimeUtils::isOverlap(&s1, &s2));
+
+    TimeUtils::compileSession(s2);
+    EXPECT_TRUE(TimeUtils::isOverlap(&s1, &s2));
+    EXPECT_TRUE(TimeUtils::isOverlap(s1.day_of_week, s1.start_minutes, s1.end_minutes,
+                                     s2.day_of_week, s2.start_minutes, s2.end_minutes));
+    EXPECT_FALSE(TimeUtils::isOverlap(3, s1.start_minutes, s1.end_minutes,
+                                      s2.day_of_week, s2.start_minutes, s2.end_minutes));
+}
@@ -0,0 +1,51 @@
+#include "WorkStealingPool.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+
+using namespace std;
+
+// --- TEST CASES ---
+
+// Every task runs exactly once regardless of how many workers steal
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce) {
+    vector<atomic<int>> counters(200);
+    vector<function<void()>> tasks;
+    for (size_t i = 0; i < counters.size(); i++) {
+        tasks.emplace_back([&counters, i]() { counters[i]++; });
+    }
+
+    WorkStealingPool pool(4);
+    pool.run(tasks);
+
+    for (const auto& counter : counters) {
+        EXPECT_EQ(counter.load(), 1);
+    }
+}
+
+// More threads than tasks and an empty batch are both handled
+TEST(WorkStealingPoolTest, FewerTasksThanThreads) {
+    atomic<int> executed{0};
+    vector<function<void()>> tasks = {[&]() { executed++; }, [&]() { executed++; }};
+
+    WorkStealingPool pool(16);
+    pool.run(tasks);
+    pool.run({});
+
+    EXPECT_EQ(executed.load(), 2);
+}
+
+// A throwing task does not stop the remaining tasks
+TEST(WorkStealingPoolTest, ThrowingTaskIsIsolated) {
+    atomic<int> executed{0};
+    vector<function<void()>> tasks;
+    tasks.emplace_back([]() { throw runtime_error("task failure"); });
+    for (int i = 0; i < 10; i++) {
+        tasks.emplace_back([&]() { executed++; });
+    }
+
+    WorkStealingPool pool(3);
+    pool.run(tasks);
+
+    EXPECT_EQ(executed.load(), 10);
+}
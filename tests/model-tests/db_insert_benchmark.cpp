@@ -0,0 +1,125 @@
+// Insert throughput of the schedule table: one row per statement (DatabaseUtils::executeBatch)
+// against multi-row statements with cached prepared queries. Not part of the test run:
+//   ./schedDbBenchmark [schedule counts...]   (default 10000 50000)
+
+#include "db_schedules.h"
+#include "db_schema.h"
+#include "db_utils.h"
+#include "ScheduleBuilder.h"
+#include "test_helpers.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QTemporaryDir>
+
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+
+    const char* const BENCHMARK_CONNECTION = "schedulify_benchmark_connection";
+    const size_t WRITER_BATCH_SIZE = 1000;
+
+    string hourText(int hour) {
+        return (hour < 10 ? "0" : "") + to_string(hour) + ":00";
+    }
+
+    // 8 courses of 4 non-overlapping lecture groups: 4^8 = 65536 schedules
+    vector<Course> makeBenchmarkCourses() {
+        vector<Course> courses;
+        for (int c = 0; c < 8; c++) {
+            Course course;
+            course.id = c + 1;
+            course.raw_id = "BM" + to_string(c + 1);
+            course.name = "Benchmark Course " + to_string(c + 1);
+
+            int day = c % 7 + 1;
+            int firstHour = c < 7 ? 8 : 16;
+            for (int g = 0; g < 4; g++) {
+                Session session = makeSession(day, hourText(firstHour + g * 2), hourText(firstHour + g * 2 + 1));
+                session.building_number = "B" + to_string(c);
+                session.room_number = to_string(100 + g);
+
+                Group group;
+                group.type = SessionType::LECTURE;
+                group.sessions = {session};
+                course.Lectures.push_back(group);
+            }
+            courses.push_back(course);
+        }
+        return courses;
+    }
+
+    // Rows per second of inserting the schedules into a fresh database, in writer-sized batches
+    double measureInserts(const vector<InformativeSchedule>& schedules, size_t count, bool multiRow) {
+        QTemporaryDir directory;
+        double rowsPerSecond = -1;
+        {
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", BENCHMARK_CONNECTION);
+            db.setDatabaseName(directory.filePath("benchmark.db"));
+            if (!db.open()) {
+                fprintf(stderr, "Failed to open benchmark database\n");
+                return -1;
+            }
+            DatabaseUtils::enableWALMode(db);
+
+            DatabaseSchema schema(db);
+            if (!schema.createTables() || !schema.createIndexes()) {
+                fprintf(stderr, "Failed to create benchmark schema\n");
+                return -1;
+            }
+
+            DatabaseScheduleManager manager(db);
+            manager.setMultiRowInserts(multiRow);
+
+            QElapsedTimer timer;
+            timer.start();
+
+            bool success = true;
+            for (size_t first = 0; first < count && success; first += WRITER_BATCH_SIZE) {
+                vector<InformativeSchedule> batch(schedules.begin() + first,
+                                                  schedules.begin() + min(count, first + WRITER_BATCH_SIZE));
+                success = manager.insertSchedules(batch);
+            }
+
+            qint64 elapsed = timer.nsecsElapsed();
+            if (success && manager.getScheduleCount() == static_cast<int>(count)) {
+                rowsPerSecond = count / (elapsed / 1e9);
+            } else {
+                fprintf(stderr, "Benchmark insert failed\n");
+            }
+            db.close();
+        }
+        QSqlDatabase::removeDatabase(BENCHMARK_CONNECTION);
+        return rowsPerSecond;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+
+    vector<size_t> counts;
+    for (int i = 1; i < argc; i++) {
+        counts.push_back(strtoul(argv[i], nullptr, 10));
+    }
+    if (counts.empty()) {
+        counts = {10000, 50000};
+    }
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> schedules = builder.buildCompact(makeBenchmarkCourses(), "A");
+    printf("Generated %zu schedules\n", schedules.size());
+
+    printf("%10s %16s %16s %8s\n", "schedules", "row/stmt (r/s)", "multi-row (r/s)", "speedup");
+    for (size_t count : counts) {
+        count = min(count, schedules.size());
+        double before = measureInserts(schedules, count, false);
+        double after = measureInserts(schedules, count, true);
+        printf("%10zu %16.0f %16.0f %7.2fx\n", count, before, after, before > 0 ? after / before : 0.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "db_schedule_blob.h"
+#include "ScheduleBuilder.h"
+#include "gtest/gtest.h"
+#include "test_helpers.h"
+
+using namespace std;
+
+// --- TEST CASES ---
+
+// Generated weeks, compact ones included, decode to the same items
+TEST(ScheduleBlobTest, RoundTripsGeneratedSchedules) {
+    vector<Course> courses = {
+            makeLectureCourse(1, {{makeSession(1, "09:00", "10:00")}, {makeSession(2, "9:30", "10:30")}}),
+            makeLectureCourse(2, {{makeSession(1, "12:00", "14:00"), makeSession(4, "08:00", "09:00")}}),
+    };
+
+    ScheduleBuilder builder;
+    vector<InformativeSchedule> compact = builder.buildCompact(courses, "A");
+    ASSERT_EQ(compact.size(), 2);
+
+    for (const auto& schedule : compact) {
+        string blob = DatabaseScheduleBlob::encode(schedule);
+
+        InformativeSchedule decoded;
+        ASSERT_TRUE(DatabaseScheduleBlob::decode(blob, decoded));
+        expectSameWeek(ScheduleSet::weekOf(schedule), decoded.week);
+    }
+}
+
+// Times outside the H:MM / HH:MM forms keep their exact text
+TEST(ScheduleBlobTest, KeepsNonCanonicalTimes) {
+    InformativeSchedule schedule;
+    ScheduleDay day;
+    day.day = "Monday";
+    for (const char* start : {"07:05", "7:05", "24:00", "9:5", "", "noon"}) {
+        ScheduleItem item;
+        item.courseName = "Course";
+        item.start = start;
+        item.end = "23:59";
+        day.day_items.push_back(item);
+    }
+    schedule.week.push_back(day);
+    schedule.week.push_back(ScheduleDay{"Tuesday", {}});
+
+    InformativeSchedule decoded;
+    ASSERT_TRUE(DatabaseScheduleBlob::decode(DatabaseScheduleBlob::encode(schedule), decoded));
+    expectSameWeek(schedule.week, decoded.week);
+}
+
+// Truncated or foreign data is rejected instead of producing a partial week
+TEST(ScheduleBlobTest, RejectsMalformedBlobs) {
+    InformativeSchedule schedule;
+    ScheduleDay day;
+    day.day = "Sunday";
+    ScheduleItem item;
+    item.courseName = "Course";
+    item.start = "10:00";
+    item.end = "12:00";
+    day.day_items.push_back(item);
+    schedule.week.push_back(day);
+
+    string blob = DatabaseScheduleBlob::encode(schedule);
+    InformativeSchedule decoded;
+
+    for (size_t length = 0; length < blob.size(); ++length) {
+        EXPECT_FALSE(DatabaseScheduleBlob::decode(blob.substr(0, length), decoded));
+        EXPECT_TRUE(decoded.week.empty());
+    }
+    EXPECT_FALSE(DatabaseScheduleBlob::decode("{\"week\":[]}", decoded));
+    EXPECT_FALSE(DatabaseScheduleBlob::decode(blob + '\0', decoded));
+}
+
+// Option tuples round-trip, and cut-off varints are rejected
+TEST(ScheduleBlobTest, RoundTripsOptionTuples) {
+    vector<uint32_t> tuple = {0, 5, 127, 128, 300000, UINT32_MAX};
+    string blob = DatabaseScheduleBlob::encodeTuple(tuple);
+
+    vector<uint32_t> decoded;
+    ASSERT_TRUE(DatabaseScheduleBlob::decodeTuple(blob, decoded));
+    EXPECT_EQ(decoded, tuple);
+
+    EXPECT_FALSE(DatabaseScheduleBlob::decodeTuple(blob.substr(0, blob.size() - 1), decoded));
+    EXPECT_TRUE(decoded.empty());
+}
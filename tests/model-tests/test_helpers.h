@@ -2,9 +2,47 @@
 #define TEST_HELPERS_H
 
 #include "model_interfaces.h"
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
 
 inline Session makeSession(int day, const std::string& start, const std::string& end) {
     return Session{.day_of_week = day, .start_time = start, .end_time = end};
 }
 
+// Course with one lecture group per entry and no other group types
+inline Course makeLectureCourse(int id, const std::vector<std::vector<Session>>& lectureGroups) {
+    Course course;
+    course.id = id;
+    course.raw_id = "R" + std::to_string(id);
+    course.name = "Course " + std::to_string(id);
+    for (const auto& sessions : lectureGroups) {
+        Group group;
+        group.type = SessionType::LECTURE;
+        group.sessions = sessions;
+        course.Lectures.push_back(group);
+    }
+    return course;
+}
+
+inline void expectSameWeek(const std::vector<ScheduleDay>& expected, const std::vector<ScheduleDay>& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t d = 0; d < expected.size(); ++d) {
+        EXPECT_EQ(expected[d].day, actual[d].day);
+        ASSERT_EQ(expected[d].day_items.size(), actual[d].day_items.size());
+        for (size_t k = 0; k < expected[d].day_items.size(); ++k) {
+            const ScheduleItem& a = expected[d].day_items[k];
+            const ScheduleItem& b = actual[d].day_items[k];
+            EXPECT_EQ(a.courseName, b.courseName);
+            EXPECT_EQ(a.raw_id, b.raw_id);
+            EXPECT_EQ(a.type, b.type);
+            EXPECT_EQ(a.start, b.start);
+            EXPECT_EQ(a.end, b.end);
+            EXPECT_EQ(a.building, b.building);
+            EXPECT_EQ(a.room, b.room);
+        }
+    }
+}
+
 #endif // TEST_HELPERS_H